@@ -0,0 +1,410 @@
+#include "AlertUtils.h"
+#include <math.h>
+#include <ctype.h>
+#include <stdlib.h>
+
+enum AlertMetric : uint8_t { METRIC_TEMP, METRIC_FEELS, METRIC_WIND, METRIC_POP, METRIC_HUMIDITY };
+enum AlertAgg : uint8_t { AGG_NOW, AGG_MAX, AGG_MIN };
+enum AlertWindow : uint8_t { WIN_HOURS, WIN_TODAY, WIN_TONIGHT };
+enum AlertOp : uint8_t { OP_GT, OP_GE, OP_LT, OP_LE };
+
+static const char *const METRIC_NAMES[] = { "temp", "feels", "wind", "pop", "humidity" };
+
+// One value the rules compare against; shared by every rule that reads it
+struct AlertField {
+  AlertMetric metric;
+  AlertAgg    agg;
+  AlertWindow window;
+  uint8_t     hours;   // WIN_HOURS length
+  uint32_t    rules;   // mask of the rules reading this field
+  float       value;   // last computed value (NAN = unknown)
+};
+
+struct AlertRule {
+  uint8_t field;       // index into s_fields
+  AlertOp op;
+  float   threshold;
+  char    name[ALERT_NAME_LEN];
+  char    text[ALERT_TEXT_LEN];
+};
+
+static AlertField s_fields[ALERT_MAX_FIELDS];
+static AlertRule  s_rules[ALERT_MAX_RULES];
+static int s_fieldCount = 0;
+static int s_ruleCount = 0;
+static uint32_t s_active = 0;
+static bool s_fresh = true;        // first update after initAlerts(): evaluate every rule
+static uint32_t s_evalSeq = 0;     // snapshot seq / "now" of the last evaluation
+static uint32_t s_evalAt = 0;
+static String s_ticker = "";
+static AlertStats s_stats = {};
+
+// -------------------------- parsing (boot only) --------------------------
+static const char *skipSpaces(const char *p) {
+  while (*p == ' ' || *p == '\t') ++p;
+  return p;
+}
+
+static char *trim(char *s) {
+  while (isspace((unsigned char)*s)) ++s;
+  size_t n = strlen(s);
+  while (n > 0 && isspace((unsigned char)s[n - 1])) s[--n] = 0;
+  return s;
+}
+
+// Lower-cased [a-z0-9_] word
+static const char *readWord(const char *p, char *buf, size_t n) {
+  size_t len = 0;
+  while (isalnum((unsigned char)*p) || *p == '_') {
+    if (len + 1 < n) buf[len++] = (char)tolower((unsigned char)*p);
+    ++p;
+  }
+  buf[len] = 0;
+  return p;
+}
+
+static int metricFromName(const char *w) {
+  for (int i = 0; i < (int)(sizeof(METRIC_NAMES) / sizeof(METRIC_NAMES[0])); ++i) {
+    if (strcmp(w, METRIC_NAMES[i]) == 0) return i;
+  }
+  return -1;
+}
+
+// <metric> | max(<metric>, <window>) | min(<metric>, <window>); returns an error or nullptr
+static const char *parseField(const char *&p, AlertField &f) {
+  char word[12];
+  p = readWord(skipSpaces(p), word, sizeof(word));
+  p = skipSpaces(p);
+  if (*p != '(') {
+    int m = metricFromName(word);
+    if (m < 0) return "unknown field";
+    f.metric = (AlertMetric)m;
+    f.agg = AGG_NOW;
+    return nullptr;
+  }
+  if (strcmp(word, "max") == 0) f.agg = AGG_MAX;
+  else if (strcmp(word, "min") == 0) f.agg = AGG_MIN;
+  else return "unknown aggregate (max, min)";
+
+  p = readWord(skipSpaces(p + 1), word, sizeof(word));
+  int m = metricFromName(word);
+  if (m < 0) return "unknown metric";
+  if (m == METRIC_FEELS) return "feels is only known for now";
+  f.metric = (AlertMetric)m;
+  p = skipSpaces(p);
+  if (*p != ',') return "expected ','";
+
+  p = readWord(skipSpaces(p + 1), word, sizeof(word));
+  if (strcmp(word, "today") == 0) {
+    f.window = WIN_TODAY;
+  } else if (strcmp(word, "tonight") == 0) {
+    f.window = WIN_TONIGHT;
+  } else {
+    char *end;
+    long h = strtol(word, &end, 10);
+    if (end == word || strcmp(end, "h") != 0 || h < 1 || h > 120) return "window must be 1h..120h, today or tonight";
+    f.window = WIN_HOURS;
+    f.hours = (uint8_t)h;
+  }
+  p = skipSpaces(p);
+  if (*p != ')') return "expected ')'";
+  ++p;
+  return nullptr;
+}
+
+// <name>: <field> <op> <number> [: <message>]
+static const char *parseRule(char *line, AlertRule &r, AlertField &f) {
+  char *colon = strchr(line, ':');
+  if (!colon) return "expected '<name>: <field> <op> <number>'";
+  *colon = 0;
+  char *name = trim(line);
+  if (!*name) return "missing rule name";
+  strlcpy(r.name, name, sizeof(r.name));
+
+  char *expr = colon + 1;
+  char *msg = strchr(expr, ':');
+  if (msg) *msg++ = 0;
+
+  const char *p = expr;
+  const char *err = parseField(p, f);
+  if (err) return err;
+  p = skipSpaces(p);
+  if (p[0] == '>') r.op = (p[1] == '=') ? OP_GE : OP_GT;
+  else if (p[0] == '<') r.op = (p[1] == '=') ? OP_LE : OP_LT;
+  else return "expected > >= < <=";
+  p += (p[1] == '=') ? 2 : 1;
+  char *end;
+  double v = strtod(p, &end);
+  if (end == p) return "expected a number";
+  if (*skipSpaces(end)) return "unexpected text after the number";
+  r.threshold = (float)v;
+
+  char *text = msg ? trim(msg) : name;
+  strlcpy(r.text, *text ? text : name, sizeof(r.text));
+  return nullptr;
+}
+
+static int findOrAddField(const AlertField &f) {
+  for (int i = 0; i < s_fieldCount; ++i) {
+    const AlertField &e = s_fields[i];
+    if (e.metric == f.metric && e.agg == f.agg &&
+        (f.agg == AGG_NOW || (e.window == f.window && e.hours == f.hours))) return i;
+  }
+  if (s_fieldCount >= ALERT_MAX_FIELDS) return -1;
+  s_fields[s_fieldCount] = f;
+  s_fields[s_fieldCount].rules = 0;
+  s_fields[s_fieldCount].value = NAN;
+  return s_fieldCount++;
+}
+
+int initAlerts(const char* rules) {
+  s_fieldCount = s_ruleCount = 0;
+  s_active = 0;
+  s_fresh = true;
+  s_ticker = "";
+  s_stats = {};
+
+  const char *p = rules ? rules : "";
+  int lineNo = 0;
+  while (*p) {
+    const char *end = p;
+    while (*end && *end != '\n' && *end != ';') ++end;
+    char line[128];
+    size_t len = min((size_t)(end - p), sizeof(line) - 1);
+    memcpy(line, p, len);
+    line[len] = 0;
+    p = *end ? end + 1 : end;
+    ++lineNo;
+
+    char *t = trim(line);
+    if (!*t || *t == '#') continue;
+    if (s_ruleCount >= ALERT_MAX_RULES) {
+      Serial.printf("AlertUtils: line %d: more than %d rules, rest ignored\n", lineNo, ALERT_MAX_RULES);
+      break;
+    }
+    AlertRule r = {};
+    AlertField f = {};
+    const char *err = parseRule(t, r, f);
+    int field = err ? -1 : findOrAddField(f);
+    if (!err && field < 0) err = "too many distinct fields";
+    if (err) {
+      Serial.printf("AlertUtils: line %d: %s\n", lineNo, err);
+      continue;
+    }
+    r.field = (uint8_t)field;
+    s_fields[field].rules |= 1UL << s_ruleCount;
+    s_rules[s_ruleCount++] = r;
+  }
+  s_stats.rules = (uint8_t)s_ruleCount;
+  s_stats.fields = (uint8_t)s_fieldCount;
+  Serial.printf("AlertUtils: %d rules over %d fields\n", s_ruleCount, s_fieldCount);
+  return s_ruleCount;
+}
+
+// -------------------------- field values --------------------------
+static float slotValue(const ForecastSlot &s, AlertMetric m) {
+  switch (m) {
+    case METRIC_TEMP:     return s.temp;
+    case METRIC_WIND:     return s.wind;
+    case METRIC_POP:      return isnan(s.pop) ? NAN : s.pop * 100.0f;
+    case METRIC_HUMIDITY: return s.humidity < 0 ? NAN : (float)s.humidity;
+    default:              return NAN;
+  }
+}
+
+static float nowValue(const WeatherDerived &d, AlertMetric m) {
+  switch (m) {
+    case METRIC_TEMP:     return d.nowTemp;
+    case METRIC_FEELS:    return d.feelsLike;
+    case METRIC_WIND:     return d.nowWind;
+    case METRIC_POP:      return isnan(d.nowPop) ? NAN : d.nowPop * 100.0f;
+    case METRIC_HUMIDITY: return d.nowHumidity < 0 ? NAN : (float)d.nowHumidity;
+    default:              return NAN;
+  }
+}
+
+// Linear interpolation at t, clamped to the forecast (as WeatherUtils' valueAt())
+static float valueAt(const WeatherSnapshot &snap, uint32_t t, AlertMetric m) {
+  if (t <= snap.slots[0].dt) return slotValue(snap.slots[0], m);
+  for (int i = 0; i + 1 < snap.count; ++i) {
+    const ForecastSlot &a = snap.slots[i];
+    const ForecastSlot &b = snap.slots[i + 1];
+    if (t >= b.dt) continue;
+    float va = slotValue(a, m), vb = slotValue(b, m);
+    if (isnan(va)) return vb;
+    if (isnan(vb) || b.dt == a.dt) return va;
+    return va + (vb - va) * (float)(t - a.dt) / (float)(b.dt - a.dt);
+  }
+  return slotValue(snap.slots[snap.count - 1], m);
+}
+
+// [from, to] in UTC for a windowed field evaluated at now
+static void windowBounds(const AlertField &f, const WeatherSnapshot &snap, uint32_t now,
+                         uint32_t &from, uint32_t &to) {
+  from = now;
+  if (f.window == WIN_HOURS) {
+    to = now + f.hours * 3600UL;
+    return;
+  }
+  long local = (long)now + snap.tzOffset;
+  long dayStart = local - (local % 86400L);
+  if (f.window == WIN_TODAY) {
+    to = (uint32_t)(dayStart + 86400L - snap.tzOffset) - 1;
+    return;
+  }
+  // tonight: 18:00 .. 09:00 city time; before 09:00 the current night is meant
+  long start = local, end = dayStart + 9 * 3600L;
+  if (local >= end) {
+    start = max(local, dayStart + 18 * 3600L);
+    end += 86400L;
+  }
+  from = (uint32_t)(start - snap.tzOffset);
+  to = (uint32_t)(end - snap.tzOffset);
+}
+
+static void fold(float &acc, float x, bool wantMax) {
+  if (isnan(x)) return;
+  if (isnan(acc) || (wantMax ? x > acc : x < acc)) acc = x;
+}
+
+// The forecast is linear between slots, so the extremes over a window are at its
+// edges or at the slots inside it
+static float computeField(const AlertField &f, const WeatherSnapshot &snap, uint32_t now) {
+  float v = nowValue(snap.derived, f.metric);
+  if (f.agg == AGG_NOW) return v;
+  uint32_t from, to;
+  windowBounds(f, snap, now, from, to);
+  bool wantMax = (f.agg == AGG_MAX);
+  if (from != now) v = valueAt(snap, from, f.metric);
+  for (int i = 0; i < snap.count && snap.slots[i].dt < to; ++i) {
+    if (snap.slots[i].dt > from) fold(v, slotValue(snap.slots[i], f.metric), wantMax);
+  }
+  fold(v, valueAt(snap, to, f.metric), wantMax);
+  return v;
+}
+
+// -------------------------- evaluation --------------------------
+static bool sameValue(float a, float b) {
+  return (isnan(a) && isnan(b)) || a == b;
+}
+
+static bool ruleHolds(const AlertRule &r, float v) {
+  if (isnan(v)) return false;
+  switch (r.op) {
+    case OP_GT: return v > r.threshold;
+    case OP_GE: return v >= r.threshold;
+    case OP_LT: return v < r.threshold;
+    default:    return v <= r.threshold;
+  }
+}
+
+// Message with "%v" replaced by the rounded field value
+static void appendMessage(String &out, const AlertRule &r) {
+  char buf[ALERT_TEXT_LEN + 16];
+  size_t n = 0;
+  const char *src = r.text;
+  while (*src && n + 1 < sizeof(buf)) {
+    if (src[0] == '%' && src[1] == 'v') {
+      float v = s_fields[r.field].value;
+      n += snprintf(buf + n, sizeof(buf) - n, "%d", isnan(v) ? 0 : (int)lroundf(v));
+      if (n >= sizeof(buf)) n = sizeof(buf) - 1;
+      src += 2;
+      continue;
+    }
+    buf[n++] = *src++;
+  }
+  buf[n] = 0;
+  out += buf;
+}
+
+static String buildTicker(uint32_t active) {
+  String out = "";
+  while (active) {
+    int i = __builtin_ctz(active);
+    active &= active - 1;
+    if (out.length() > 0) out += "  *  ";
+    appendMessage(out, s_rules[i]);
+  }
+  return out;
+}
+
+bool alertsUpdate(const WeatherSnapshot &snap) {
+  if (s_ruleCount == 0) return false;
+  bool known = snap.valid && snap.count > 0 && snap.derived.valid;
+  uint32_t now = known ? snap.derived.computedAt : 0;
+  if (!s_fresh && snap.seq == s_evalSeq && now == s_evalAt) return false;
+  uint32_t startUs = micros();
+
+  // recompute the fields; collect the rules whose input changed
+  uint32_t dirty = s_fresh ? (s_ruleCount == 32 ? 0xFFFFFFFFUL : (1UL << s_ruleCount) - 1) : 0;
+  for (int i = 0; i < s_fieldCount; ++i) {
+    AlertField &f = s_fields[i];
+    float v = known ? computeField(f, snap, now) : NAN;
+    if (sameValue(v, f.value)) continue;
+    f.value = v;
+    dirty |= f.rules;
+    s_stats.fieldChanges++;
+  }
+
+  uint32_t active = s_active;
+  for (uint32_t m = dirty; m; m &= m - 1) {
+    int i = __builtin_ctz(m);
+    const AlertRule &r = s_rules[i];
+    if (ruleHolds(r, s_fields[r.field].value)) active |= 1UL << i;
+    else active &= ~(1UL << i);
+    s_stats.ruleEvals++;
+  }
+
+  // the text follows the active set and, through "%v", the active rules' values
+  bool changed = false;
+  if (active != s_active || (dirty & active)) {
+    String text = buildTicker(active);
+    changed = (text != s_ticker);
+    s_ticker = text;
+  }
+  if (active != s_active) {
+    Serial.printf("AlertUtils: active %08lx -> %08lx\n", (unsigned long)s_active, (unsigned long)active);
+  }
+  s_active = active;
+  s_fresh = false;
+  s_evalSeq = snap.seq;
+  s_evalAt = now;
+
+  s_stats.active = active;
+  s_stats.updates++;
+  s_stats.lastUs = micros() - startUs;
+  if (s_stats.lastUs > s_stats.maxUs) s_stats.maxUs = s_stats.lastUs;
+  return changed;
+}
+
+uint32_t alertsActiveMask() {
+  return s_active;
+}
+
+int alertsActiveCount() {
+  return __builtin_popcount(s_active);
+}
+
+String alertsTickerText() {
+  return s_ticker;
+}
+
+bool alertsLedColor(uint8_t &r, uint8_t &g, uint8_t &b) {
+  if (s_active == 0) return false;
+  const AlertRule &rule = s_rules[__builtin_ctz(s_active)];
+  switch (s_fields[rule.field].metric) {
+    case METRIC_POP:      r = 0;   g = 60;  b = 255; break;  // rain: blue
+    case METRIC_WIND:     r = 200; g = 200; b = 255; break;  // wind: cold white
+    case METRIC_HUMIDITY: r = 40;  g = 200; b = 60;  break;
+    default:
+      // temperature: icy below a threshold (freeze), red above it (heat)
+      if (rule.op == OP_LT || rule.op == OP_LE) { r = 180; g = 220; b = 255; }
+      else { r = 255; g = 40; b = 0; }
+      break;
+  }
+  return true;
+}
+
+AlertStats getAlertStats() {
+  return s_stats;
+}
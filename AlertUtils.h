@@ -0,0 +1,60 @@
+#ifndef ALERTUTILS_H
+#define ALERTUTILS_H
+
+#include <Arduino.h>
+#include "WeatherUtils.h"  // WeatherSnapshot
+
+/*
+  AlertUtils - threshold alerts over the weather snapshot
+  - Rules are plain text, parsed once by initAlerts() into a fixed predicate table;
+    nothing is parsed or allocated afterwards. One rule per line (or ';'):
+        <name>: <field> <op> <number> [: <message>]
+      field   temp | feels | wind | pop | humidity          value now
+              max(<metric>, <window>) | min(<metric>, <window>)
+      window  <N>h (now .. now+N h) | today (rest of the city-local day) |
+              tonight (18:00 .. 09:00 city time, from now if already inside)
+      op      > >= < <=        pop and humidity in percent
+      message ticker text; "%v" is replaced by the field value (default: name)
+    e.g.  "rain: max(pop, 3h) >= 60 : Rain %v% in the next 3 h"
+  - Rules that read the same field share one slot of the field table. On each
+    alertsUpdate() the fields are recomputed (slots and window edges only: the
+    forecast is piecewise linear) and only rules whose field value changed are
+    re-evaluated. The active set is a bitmask kept across updates.
+  - Rules are evaluated at the snapshot's "now" (derived.computedAt), which
+    updateNowcast() moves to the current minute, so windows slide with the clock.
+    alertsUpdate() does work only when the snapshot or that minute changed.
+*/
+
+const int ALERT_MAX_RULES  = 32;  // bits of the active mask
+const int ALERT_MAX_FIELDS = 16;  // distinct fields over all rules
+const int ALERT_NAME_LEN   = 12;
+const int ALERT_TEXT_LEN   = 48;
+
+// Parse the rule text (replaces any previous rules). Bad lines are reported on Serial
+// and skipped. Returns the number of rules loaded.
+int initAlerts(const char* rules);
+
+// Re-evaluate against the snapshot (call after each fetch and updateNowcast()).
+// Returns true if the ticker text changed.
+bool alertsUpdate(const WeatherSnapshot &snap);
+
+uint32_t alertsActiveMask();      // bit i = rule i (config order) is active
+int alertsActiveCount();
+String alertsTickerText();        // active alert messages joined, "" when none
+
+// LED flash color for the first active alert (by its metric; false when none)
+bool alertsLedColor(uint8_t &r, uint8_t &g, uint8_t &b);
+
+struct AlertStats {
+  uint8_t  rules;           // rules loaded
+  uint8_t  fields;          // distinct fields computed per update
+  uint32_t active;          // active mask
+  uint32_t updates;         // alertsUpdate() calls that evaluated
+  uint32_t fieldChanges;    // field values that changed (summed over updates)
+  uint32_t ruleEvals;       // rule predicates evaluated (summed over updates)
+  uint32_t lastUs;          // duration of the last evaluating update
+  uint32_t maxUs;
+};
+AlertStats getAlertStats();
+
+#endif // ALERTUTILS_H
@@ -0,0 +1,368 @@
+#include "ConsoleUtils.h"
+#include "WeatherUtils.h"   // getWeatherSnapshot(), getWeatherFetchStats()
+#include "StatusUtils.h"    // getLoopFrameStats()
+#include "TickerUtils.h"
+#include "GraphUtils.h"     // getGraphAnimStats()
+#include "AlertUtils.h"
+#include "NetUtils.h"
+#include "TextUtils.h"      // getTextCacheStats()
+#include "FramebufferUtils.h" // DISPLAY_FRAMEBUFFER
+#include <Preferences.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>        // strcasecmp()
+#include <time.h>
+
+static const ConsoleVar *s_vars = nullptr;
+static uint8_t s_varCount = 0;
+
+static char    s_line[CONSOLE_LINE_LEN + 1];
+static uint8_t s_len = 0;
+static bool    s_overflow = false;       // skipping the rest of an overlong line
+static bool    s_fetchRequested = false;
+
+static ConsoleStats s_stats = {};
+
+// Cuts the next space-separated token in place; p moves past it ("" at the end)
+static char *nextToken(char *&p) {
+  while (*p == ' ' || *p == '\t') ++p;
+  char *tok = p;
+  while (*p && *p != ' ' && *p != '\t') ++p;
+  if (*p) *p++ = '\0';
+  return tok;
+}
+
+// -------------------------- tunables --------------------------
+static const ConsoleVar *findVar(const char *name) {
+  for (uint8_t i = 0; i < s_varCount; ++i) {
+    if (strcasecmp(s_vars[i].name, name) == 0) return &s_vars[i];
+  }
+  return nullptr;
+}
+
+static void printVar(const ConsoleVar &v) {
+  switch (v.type) {
+    case CONSOLE_INT:   Serial.printf("%s = %d\n", v.name, *(int *)v.ptr); break;
+    case CONSOLE_U8:    Serial.printf("%s = %u\n", v.name, (unsigned)*(uint8_t *)v.ptr); break;
+    case CONSOLE_ULONG: Serial.printf("%s = %lu\n", v.name, *(unsigned long *)v.ptr); break;
+    case CONSOLE_STR:   Serial.printf("%s = \"%s\"\n", v.name, (const char *)v.ptr); break;
+  }
+}
+
+static bool storeNumber(const ConsoleVar &v, long x) {
+  if (x < v.minV || x > v.maxV) return false;
+  switch (v.type) {
+    case CONSOLE_INT:   *(int *)v.ptr = (int)x; break;
+    case CONSOLE_U8:    *(uint8_t *)v.ptr = (uint8_t)x; break;
+    case CONSOLE_ULONG: *(unsigned long *)v.ptr = (unsigned long)x; break;
+    default: return false;
+  }
+  return true;
+}
+
+// Parses text into the variable; false (variable unchanged) when it does not fit
+static bool setVar(const ConsoleVar &v, const char *text) {
+  if (v.type == CONSOLE_STR) {
+    size_t n = strlen(text);
+    if (n == 0 || n >= (size_t)v.maxV) return false;
+    memcpy(v.ptr, text, n + 1);
+    return true;
+  }
+  char *end;
+  long x = strtol(text, &end, 10);
+  if (end == text || *end) return false;
+  return storeNumber(v, x);
+}
+
+static void loadVars() {
+  Preferences prefs;
+  if (!prefs.begin("console", true)) return;
+  for (uint8_t i = 0; i < s_varCount; ++i) {
+    const ConsoleVar &v = s_vars[i];
+    if (!prefs.isKey(v.key)) continue;
+    switch (v.type) {
+      case CONSOLE_INT:   storeNumber(v, (long)prefs.getInt(v.key, *(int *)v.ptr)); break;
+      case CONSOLE_U8:    storeNumber(v, (long)prefs.getUChar(v.key, *(uint8_t *)v.ptr)); break;
+      case CONSOLE_ULONG: storeNumber(v, (long)prefs.getULong(v.key, *(unsigned long *)v.ptr)); break;
+      case CONSOLE_STR: {
+        size_t n = prefs.getBytesLength(v.key);
+        if (n > 0 && n < (size_t)v.maxV && prefs.getBytes(v.key, v.ptr, n) == n) ((char *)v.ptr)[n] = '\0';
+        break;
+      }
+    }
+  }
+  prefs.end();
+}
+
+static bool saveVars() {
+  Preferences prefs;
+  if (!prefs.begin("console", false)) return false;
+  bool ok = true;
+  for (uint8_t i = 0; i < s_varCount; ++i) {
+    const ConsoleVar &v = s_vars[i];
+    size_t n = 0;
+    switch (v.type) {
+      case CONSOLE_INT:   n = prefs.putInt(v.key, *(int *)v.ptr); break;
+      case CONSOLE_U8:    n = prefs.putUChar(v.key, *(uint8_t *)v.ptr); break;
+      case CONSOLE_ULONG: n = prefs.putULong(v.key, (uint32_t)*(unsigned long *)v.ptr); break;
+      case CONSOLE_STR:   n = prefs.putBytes(v.key, v.ptr, strlen((const char *)v.ptr)); break;
+    }
+    if (n == 0) ok = false;
+  }
+  prefs.end();
+  return ok;
+}
+
+// -------------------------- commands --------------------------
+typedef void (*CommandFn)(char *args);
+struct Command {
+  const char *name;
+  const char *usage;
+  CommandFn   fn;
+};
+
+static void cmdHelp(char *args);
+
+static void cmdGet(char *args) {
+  const char *name = nextToken(args);
+  if (!*name) {
+    for (uint8_t i = 0; i < s_varCount; ++i) printVar(s_vars[i]);
+    return;
+  }
+  const ConsoleVar *v = findVar(name);
+  if (!v) {
+    Serial.printf("console: no tunable '%s'\n", name);
+    s_stats.errors++;
+    return;
+  }
+  printVar(*v);
+}
+
+static void cmdSet(char *args) {
+  const char *name = nextToken(args);
+  while (*args == ' ' || *args == '\t') ++args;
+  char *value = args;   // the rest of the line (strings may hold spaces)
+  size_t n = strlen(value);
+  while (n > 0 && (value[n - 1] == ' ' || value[n - 1] == '\t')) value[--n] = '\0';
+
+  const ConsoleVar *v = findVar(name);
+  if (!v) {
+    Serial.printf("console: no tunable '%s'\n", name);
+    s_stats.errors++;
+    return;
+  }
+  if (!setVar(*v, value)) {
+    if (v->type == CONSOLE_STR) Serial.printf("console: %s takes 1..%ld characters\n", v->name, v->maxV - 1);
+    else Serial.printf("console: %s takes %ld..%ld\n", v->name, v->minV, v->maxV);
+    s_stats.errors++;
+    return;
+  }
+  printVar(*v);
+  if (v->onChange) v->onChange();
+}
+
+static void cmdSave(char *args) {
+  (void)args;
+  if (saveVars()) Serial.printf("saved %u tunables\n", (unsigned)s_varCount);
+  else {
+    Serial.println("console: NVS write failed");
+    s_stats.errors++;
+  }
+}
+
+static void cmdDefaults(char *args) {
+  (void)args;
+  Preferences prefs;
+  if (prefs.begin("console", false)) {
+    prefs.clear();
+    prefs.end();
+  }
+  Serial.println("stored tunables cleared (compiled-in values after reboot)");
+}
+
+static void cmdFetch(char *args) {
+  (void)args;
+  s_fetchRequested = true;
+  Serial.println("fetch requested");
+}
+
+static void cmdProf(char *args) {
+  (void)args;
+  LoopFrameStats fs = getLoopFrameStats();
+  Serial.printf("frame:   %lu drawn, last %lu us, avg %lu us, max %lu us\n", (unsigned long)fs.frames,
+                (unsigned long)fs.lastUs, (unsigned long)fs.avgUs, (unsigned long)fs.maxUs);
+  const TickerStats &ts = getTickerStats();
+  Serial.printf("ticker:  frame %lu us (max %lu), render %lu us, %u queued, %lu switches\n",
+                (unsigned long)ts.frameUs, (unsigned long)ts.frameMaxUs, (unsigned long)ts.renderUs,
+                (unsigned)ts.depth, (unsigned long)ts.switches);
+  const GraphAnimStats &ga = getGraphAnimStats();
+  Serial.printf("graph:   %lu morphs, %lu frames, last %lu us (max %lu), %lu skipped, %lu over budget\n",
+                (unsigned long)ga.transitions, (unsigned long)ga.frames, (unsigned long)ga.lastUs,
+                (unsigned long)ga.maxUs, (unsigned long)ga.skipped, (unsigned long)ga.overBudget);
+  AlertStats as = getAlertStats();
+  Serial.printf("alerts:  %u rules, %d active, eval %lu us (max %lu)\n", (unsigned)as.rules,
+                __builtin_popcount(as.active), (unsigned long)as.lastUs, (unsigned long)as.maxUs);
+  const WeatherFetchStats &wf = getWeatherFetchStats();
+  Serial.printf("fetch:   %lu attempts, %lu failed, last %lu ms\n", (unsigned long)wf.attempts,
+                (unsigned long)wf.failures, (unsigned long)wf.lastLatencyMs);
+  NetStats ns = getNetStats();
+  Serial.printf("wifi:    %lu connects (%lu failed), last %lu ms (max %lu)\n", (unsigned long)ns.connects,
+                (unsigned long)ns.failures, (unsigned long)ns.lastConnectMs, (unsigned long)ns.maxConnectMs);
+  const TextCacheStats &tc = getTextCacheStats();
+#if DISPLAY_FRAMEBUFFER
+  Serial.printf("text:    framebuffer runs, %lu glyphs, last %lu us (max %lu)\n", (unsigned long)tc.runGlyphs,
+                (unsigned long)tc.lastUs, (unsigned long)tc.maxUs);
+#else
+  Serial.printf("text:    %lu glyph hits, %lu misses, %lu evictions, last %lu us (max %lu)\n",
+                (unsigned long)tc.hits, (unsigned long)tc.misses, (unsigned long)tc.evictions,
+                (unsigned long)tc.lastUs, (unsigned long)tc.maxUs);
+#endif
+  Serial.printf("console: %lu commands, %lu errors, input %lu us (max %lu), last command %lu us\n",
+                (unsigned long)s_stats.lines, (unsigned long)s_stats.errors, (unsigned long)s_stats.serviceUs,
+                (unsigned long)s_stats.serviceMaxUs, (unsigned long)s_stats.commandUs);
+}
+
+static void cmdHeap(char *args) {
+  (void)args;
+#if defined(ARDUINO_ARCH_ESP32)
+  Serial.printf("heap:    %lu free, %lu minimum, %lu largest block; loop stack %lu bytes spare\n",
+                (unsigned long)ESP.getFreeHeap(), (unsigned long)ESP.getMinFreeHeap(),
+                (unsigned long)ESP.getMaxAllocHeap(), (unsigned long)uxTaskGetStackHighWaterMark(NULL));
+#else
+  Serial.println("heap:    not available on this build");
+#endif
+}
+
+static void cmdSnap(char *args) {
+  (void)args;
+  const WeatherSnapshot &s = getWeatherSnapshot();
+  if (!s.valid) {
+    Serial.println("snapshot: none");
+    return;
+  }
+  Serial.printf("snapshot: #%lu %s \"%s\", %u slots, tz %+ld s, fetched at %lu\n", (unsigned long)s.seq,
+                s.city, s.desc, (unsigned)s.count, (long)s.tzOffset, (unsigned long)s.fetchedAt);
+  const WeatherDerived &d = s.derived;
+  if (d.valid) {
+    Serial.printf("now:     %.1fF, wind %.1f mph, pop %.0f%%, humidity %d%%, feels %.1fF, %+.1fF in 3 h\n",
+                  d.nowTemp, d.nowWind, d.nowPop * 100.0f, (int)d.nowHumidity, d.feelsLike, d.trend3h);
+    Serial.printf("today:   hi %.1fF, lo %.1fF", d.todayHi, d.todayLo);
+    if (d.nextRainAt) {
+      long mins = ((long)d.nextRainAt - (long)d.computedAt) / 60;
+      Serial.printf(", rain %.0f%% in %ld min\n", d.nextRainPop * 100.0f, mins);
+    } else {
+      Serial.println(", no rain ahead");
+    }
+  }
+  for (uint8_t i = 0; i < s.count; ++i) {
+    const ForecastSlot &f = s.slots[i];
+    time_t local = (time_t)f.dt + s.tzOffset;
+    struct tm tm;
+    gmtime_r(&local, &tm);
+    Serial.printf("  %02d/%02d %02d:00  %5.1fF %5.1f mph %4.0f%% %4d%%\n", tm.tm_mon + 1, tm.tm_mday,
+                  tm.tm_hour, f.temp, f.wind, f.pop * 100.0f, (int)f.humidity);
+  }
+}
+
+static const Command COMMANDS[] = {
+  { "help",     "",               cmdHelp },
+  { "get",      "[name]",         cmdGet },
+  { "set",      "<name> <value>", cmdSet },
+  { "save",     "",               cmdSave },
+  { "defaults", "",               cmdDefaults },
+  { "fetch",    "",               cmdFetch },
+  { "prof",     "",               cmdProf },
+  { "heap",     "",               cmdHeap },
+  { "snap",     "",               cmdSnap },
+};
+const uint8_t NUM_COMMANDS = sizeof(COMMANDS) / sizeof(COMMANDS[0]);
+
+static void cmdHelp(char *args) {
+  (void)args;
+  Serial.println("commands:");
+  for (uint8_t i = 0; i < NUM_COMMANDS; ++i) Serial.printf("  %s %s\n", COMMANDS[i].name, COMMANDS[i].usage);
+  Serial.println("tunables:");
+  for (uint8_t i = 0; i < s_varCount; ++i) {
+    const ConsoleVar &v = s_vars[i];
+    if (v.type == CONSOLE_STR) Serial.printf("  %s (text, up to %ld)\n", v.name, v.maxV - 1);
+    else Serial.printf("  %s (%ld..%ld)\n", v.name, v.minV, v.maxV);
+  }
+}
+
+static void runLine(char *line) {
+  Serial.printf("> %s\n", line);
+  char *p = line;
+  const char *name = nextToken(p);
+  for (uint8_t i = 0; i < NUM_COMMANDS; ++i) {
+    if (strcasecmp(COMMANDS[i].name, name) == 0) {
+      COMMANDS[i].fn(p);
+      s_stats.lines++;
+      return;
+    }
+  }
+  Serial.printf("console: unknown command '%s' (try help)\n", name);
+  s_stats.errors++;
+}
+
+// -------------------------- public API --------------------------
+void initConsole(const ConsoleVar *vars, uint8_t count) {
+  s_vars = vars;
+  s_varCount = count;
+  s_len = 0;
+  s_overflow = false;
+  loadVars();
+  Serial.println("Console ready (type help)");
+}
+
+void consoleService() {
+  int avail = Serial.available();
+  if (avail <= 0) return;
+
+  uint32_t t0 = micros();
+  if (avail > CONSOLE_READ_MAX) avail = CONSOLE_READ_MAX;
+  bool ready = false;
+  while (avail-- > 0) {
+    int c = Serial.read();
+    if (c < 0) break;
+    if (c == '\r' || c == '\n') {
+      if (s_overflow) {
+        Serial.println("console: line too long");
+        s_stats.errors++;
+        s_overflow = false;
+        s_len = 0;
+      } else if (s_len > 0) {
+        s_line[s_len] = '\0';
+        ready = true;
+        break;   // one command per pass; further input waits for the next one
+      }
+      continue;
+    }
+    if (s_overflow) continue;
+    if (c == '\b' || c == 127) {
+      if (s_len > 0) --s_len;
+    } else if (s_len >= CONSOLE_LINE_LEN) {
+      s_overflow = true;
+    } else if (c >= ' ' && c < 127) {
+      s_line[s_len++] = (char)c;
+    }
+  }
+  s_stats.serviceUs = micros() - t0;
+  if (s_stats.serviceUs > s_stats.serviceMaxUs) s_stats.serviceMaxUs = s_stats.serviceUs;
+
+  if (ready) {
+    uint32_t t1 = micros();
+    runLine(s_line);
+    s_len = 0;
+    s_stats.commandUs = micros() - t1;
+  }
+}
+
+bool consoleTakeFetchRequest() {
+  bool r = s_fetchRequested;
+  s_fetchRequested = false;
+  return r;
+}
+
+const ConsoleStats &getConsoleStats() {
+  return s_stats;
+}
@@ -0,0 +1,67 @@
+#ifndef CONSOLEUTILS_H
+#define CONSOLEUTILS_H
+
+#include <Arduino.h>
+
+/*
+  ConsoleUtils - serial console for live tuning (Serial, one command per line)
+  - consoleService() runs once per loop() pass. It moves the bytes already received
+    (at most CONSOLE_READ_MAX per pass) into a fixed line buffer and runs a complete
+    line through a static command table: tokens are cut in place, nothing is allocated.
+    With no input a pass costs one Serial.available().
+  - Tunables are the sketch's own globals, described by a ConsoleVar table handed to
+    initConsole(): read and set by name, range-checked, with an optional change hook.
+  - "save" writes every tunable to NVS (Preferences namespace "console"); initConsole()
+    loads saved values over the compiled-in defaults, so call it before setup() uses
+    them. Hooks are not run on load.
+
+  Commands:
+    help                  this list
+    get [name]            one tunable, or all of them
+    set <name> <value>    change a tunable now (strings: the rest of the line)
+    save                  store all tunables in NVS
+    defaults              forget the stored tunables (compiled-in values after reboot)
+    fetch                 forecast fetch on the next loop() pass (fetchForecastNow())
+    prof                  frame, ticker, graph, alert, fetch and console timings
+    heap                  free / minimum / largest heap block
+    snap                  current forecast snapshot and derived values
+*/
+
+const uint8_t CONSOLE_LINE_LEN = 96;   // longer lines are dropped
+const uint8_t CONSOLE_READ_MAX = 32;   // bytes taken per consoleService() call
+
+enum ConsoleVarType : uint8_t {
+  CONSOLE_INT,      // int
+  CONSOLE_U8,       // uint8_t
+  CONSOLE_ULONG,    // unsigned long (millisecond periods)
+  CONSOLE_STR       // char[], maxV = buffer size
+};
+
+struct ConsoleVar {
+  const char    *name;      // console name (matched without case)
+  const char    *key;       // NVS key (at most 15 characters)
+  ConsoleVarType type;
+  void          *ptr;
+  long           minV;      // numbers: accepted range
+  long           maxV;
+  void         (*onChange)();   // after a "set" (nullptr = none)
+};
+
+void initConsole(const ConsoleVar *vars, uint8_t count);
+
+// Call on every loop() pass
+void consoleService();
+
+// True once after a "fetch" command (the loop runs the fetch and its follow-up)
+bool consoleTakeFetchRequest();
+
+struct ConsoleStats {
+  uint32_t lines;           // commands run
+  uint32_t errors;          // unknown commands, bad values, overlong lines
+  uint32_t serviceUs;       // input handling of the last consoleService() that read bytes
+  uint32_t serviceMaxUs;
+  uint32_t commandUs;       // last command (dumps print here)
+};
+const ConsoleStats &getConsoleStats();
+
+#endif // CONSOLEUTILS_H
@@ -0,0 +1,475 @@
+#include "DisplayDmaUtils.h"
+
+#if defined(ARDUINO_ARCH_ESP32) && DISPLAY_DMA
+#include <SPI.h>
+#include <driver/spi_master.h>
+#include <driver/gpio.h>
+#include <esp_heap_caps.h>
+#include <esp_attr.h>
+
+#define DT_HOST  SPI3_HOST   // SPI2 stays with the Arduino driver for init/rotation
+#define DT_QUEUE 16          // transactions in flight (commands + bands)
+
+#define ST_CASET 0x2A
+#define ST_RASET 0x2B
+#define ST_RAMWR 0x2C
+
+// Transactions complete in queue order, so the slots are used as a ring
+struct DtSlot {
+  spi_transaction_t t;   // first member: the driver hands back &t
+  int8_t band;           // band buffer read by t (-1 = none)
+  void (*cb)(void *);    // fence callback, run when t is reaped
+  void *arg;
+};
+
+static spi_device_handle_t s_dev = nullptr;
+static int8_t  s_dcPin = -1;
+static DtSlot  s_slots[DT_QUEUE];
+static uint8_t s_head = 0;
+static uint8_t s_inflight = 0;
+
+// Ping-pong bands: s_fill is being filled, the other one may be on the bus
+static uint16_t *s_band[2] = { nullptr, nullptr };
+static uint8_t   s_bandRefs[2] = { 0, 0 };
+static uint8_t   s_fill = 0;
+static uint32_t  s_fillLen = 0;
+
+static bool     s_polled = false;                 // current window is sent by polling
+static uint32_t s_winX = 0xFFFFFFFF, s_winY = 0xFFFFFFFF; // last CASET / RASET payload
+DMA_ATTR static uint16_t s_small[DISPLAY_DMA_SMALL_PX];
+static DisplayDmaStats s_stats = {};
+
+// DC level travels in t->user (0 = command, 1 = data)
+static void IRAM_ATTR dcPreCb(spi_transaction_t *t) {
+  gpio_set_level((gpio_num_t)s_dcPin, (int)(intptr_t)t->user);
+}
+
+// -------------------------- queue bookkeeping --------------------------
+static bool reapOne(TickType_t wait) {
+  if (s_inflight == 0) return false;
+  spi_transaction_t *rt = nullptr;
+  uint32_t t0 = micros();
+  esp_err_t err = spi_device_get_trans_result(s_dev, &rt, wait);
+  if (wait) s_stats.waitUs += micros() - t0;
+  if (err != ESP_OK) return false;
+  DtSlot *slot = (DtSlot *)rt;
+  s_inflight--;
+  if (slot->band >= 0) s_bandRefs[slot->band]--;
+  if (slot->cb) {
+    void (*cb)(void *) = slot->cb;
+    slot->cb = nullptr;
+    cb(slot->arg);
+  }
+  return true;
+}
+
+static DtSlot *nextSlot(int8_t band, int dc) {
+  if (s_inflight == DT_QUEUE) reapOne(portMAX_DELAY);
+  DtSlot *slot = &s_slots[s_head];
+  s_head = (s_head + 1) % DT_QUEUE;
+  s_inflight++;
+  memset(&slot->t, 0, sizeof(slot->t));
+  slot->t.user = (void *)(intptr_t)dc;
+  slot->band = band;
+  slot->cb = nullptr;
+  return slot;
+}
+
+static void flushBand() {
+  if (s_fillLen == 0) return;
+  DtSlot *slot = nextSlot(s_fill, 1);
+  slot->t.tx_buffer = s_band[s_fill];
+  slot->t.length = s_fillLen * 16;
+  s_bandRefs[s_fill]++;
+  spi_device_queue_trans(s_dev, &slot->t, portMAX_DELAY);
+  s_stats.bands++;
+  s_stats.bytes += s_fillLen * 2;
+  s_fill ^= 1;
+  s_fillLen = 0;
+}
+
+static void drain() {
+  flushBand();
+  while (s_inflight) reapOne(portMAX_DELAY);
+}
+
+// Room left in the band being filled (waits for it to come back from the bus first)
+static uint32_t bandRoom() {
+  if (s_fillLen == 0) {
+    while (s_bandRefs[s_fill]) reapOne(portMAX_DELAY);
+  }
+  return DISPLAY_DMA_BAND_PX - s_fillLen;
+}
+
+// -------------------------- transfers --------------------------
+static void sendBytes(int dc, const uint8_t *p, int n) {
+  static spi_transaction_t pt;
+  spi_transaction_t *t = &pt;
+  if (s_polled) memset(&pt, 0, sizeof(pt));
+  else t = &nextSlot(-1, dc)->t;
+  t->flags = SPI_TRANS_USE_TXDATA;
+  t->length = n * 8;
+  t->user = (void *)(intptr_t)dc;
+  memcpy(t->tx_data, p, n);
+  if (s_polled) {
+    spi_device_polling_transmit(s_dev, t);
+    s_stats.polled++;
+  } else {
+    spi_device_queue_trans(s_dev, t, portMAX_DELAY);
+  }
+}
+
+static void sendSmallPixels(uint32_t n) {
+  spi_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.tx_buffer = s_small;
+  t.length = n * 16;
+  t.user = (void *)1;
+  spi_device_polling_transmit(s_dev, &t);
+  s_stats.polled++;
+}
+
+static void dtWindow(uint16_t x0, uint16_t y0, uint16_t x1, uint16_t y1) {
+  uint32_t area = (uint32_t)(x1 - x0 + 1) * (uint32_t)(y1 - y0 + 1);
+  bool small = area <= DISPLAY_DMA_SMALL_PX;
+  // polling needs an empty queue; queued windows only need the pending band ahead of them
+  if (small) drain();
+  else flushBand();
+  s_polled = small;
+
+  uint8_t cmd, b[4];
+  uint32_t xa = ((uint32_t)x0 << 16) | x1;
+  uint32_t ya = ((uint32_t)y0 << 16) | y1;
+  if (xa != s_winX) {
+    cmd = ST_CASET; sendBytes(0, &cmd, 1);
+    b[0] = xa >> 24; b[1] = xa >> 16; b[2] = xa >> 8; b[3] = xa;
+    sendBytes(1, b, 4);
+    s_winX = xa;
+  }
+  if (ya != s_winY) {
+    cmd = ST_RASET; sendBytes(0, &cmd, 1);
+    b[0] = ya >> 24; b[1] = ya >> 16; b[2] = ya >> 8; b[3] = ya;
+    sendBytes(1, b, 4);
+    s_winY = ya;
+  }
+  cmd = ST_RAMWR; sendBytes(0, &cmd, 1);
+}
+
+static void dtPixels(const uint16_t *px, uint32_t n, bool bigEndian) {
+  while (n) {
+    uint32_t room = s_polled ? DISPLAY_DMA_SMALL_PX : bandRoom();
+    uint32_t k = n < room ? n : room;
+    uint16_t *dst = s_polled ? s_small : s_band[s_fill] + s_fillLen;
+    if (bigEndian) memcpy(dst, px, k * 2);
+    else for (uint32_t i = 0; i < k; ++i) dst[i] = displayDmaSwap(px[i]);
+    px += k; n -= k;
+    if (s_polled) { sendSmallPixels(k); continue; }
+    s_fillLen += k;
+    if (s_fillLen == DISPLAY_DMA_BAND_PX) flushBand();
+  }
+}
+
+static void dtColor(uint16_t color, uint32_t n) {
+  uint16_t c = displayDmaSwap(color);
+  while (n) {
+    uint32_t room = s_polled ? DISPLAY_DMA_SMALL_PX : bandRoom();
+    uint32_t k = n < room ? n : room;
+    uint16_t *dst = s_polled ? s_small : s_band[s_fill] + s_fillLen;
+    for (uint32_t i = 0; i < k; ++i) dst[i] = c;
+    n -= k;
+    if (s_polled) { sendSmallPixels(k); continue; }
+    s_fillLen += k;
+    if (s_fillLen == DISPLAY_DMA_BAND_PX) flushBand();
+  }
+}
+
+static bool dtStart(int8_t sck, int8_t mosi, int8_t cs, int8_t dc, uint32_t hz, uint8_t mode) {
+  if (!s_band[0]) {
+    for (int i = 0; i < 2; ++i) s_band[i] = (uint16_t *)heap_caps_malloc(DISPLAY_DMA_BAND_PX * 2, MALLOC_CAP_DMA);
+    if (!s_band[0] || !s_band[1]) {
+      Serial.println("DisplayDmaUtils: no DMA-capable memory for the bands");
+      for (int i = 0; i < 2; ++i) { heap_caps_free(s_band[i]); s_band[i] = nullptr; }
+      return false;
+    }
+  }
+
+  spi_bus_config_t bus = {};
+  bus.mosi_io_num = mosi;
+  bus.miso_io_num = -1;
+  bus.sclk_io_num = sck;
+  bus.quadwp_io_num = -1;
+  bus.quadhd_io_num = -1;
+  bus.max_transfer_sz = DISPLAY_DMA_BAND_PX * 2;
+  if (spi_bus_initialize(DT_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK) {
+    Serial.println("DisplayDmaUtils: spi_bus_initialize failed");
+    return false;
+  }
+
+  spi_device_interface_config_t dev = {};
+  dev.clock_speed_hz = (int)hz;
+  dev.mode = mode;
+  dev.spics_io_num = cs;
+  dev.queue_size = DT_QUEUE;
+  dev.pre_cb = dcPreCb;
+  if (spi_bus_add_device(DT_HOST, &dev, &s_dev) != ESP_OK) {
+    Serial.println("DisplayDmaUtils: spi_bus_add_device failed");
+    spi_bus_free(DT_HOST);
+    s_dev = nullptr;
+    return false;
+  }
+
+  s_dcPin = dc;
+  s_head = 0; s_inflight = 0;
+  s_fill = 0; s_fillLen = 0;
+  s_bandRefs[0] = s_bandRefs[1] = 0;
+  s_polled = false;
+  s_winX = s_winY = 0xFFFFFFFF;
+  return true;
+}
+
+static void dtStop() {
+  if (!s_dev) return;
+  drain();
+  spi_bus_remove_device(s_dev);
+  spi_bus_free(DT_HOST);
+  s_dev = nullptr;
+}
+
+// -------------------------- public transport API --------------------------
+uint16_t *displayDmaBandBegin(uint32_t *capacity) {
+  if (!s_dev || s_polled) { *capacity = 0; return nullptr; }
+  *capacity = bandRoom();
+  return s_band[s_fill] + s_fillLen;
+}
+
+void displayDmaBandCommit(uint32_t pixels) {
+  s_fillLen += pixels;
+  if (s_fillLen >= DISPLAY_DMA_BAND_PX) flushBand();
+}
+
+void displayDmaFence(void (*cb)(void *), void *arg) {
+  if (s_dev) flushBand();
+  if (!s_dev || s_inflight == 0) { cb(arg); return; }
+  DtSlot &last = s_slots[(s_head + DT_QUEUE - 1) % DT_QUEUE];
+  if (last.cb) { drain(); cb(arg); return; } // one callback per transaction
+  last.cb = cb;
+  last.arg = arg;
+}
+
+void displayDmaPoll() {
+  while (s_dev && reapOne(0)) {}
+}
+
+void displayDmaWaitIdle() {
+  if (s_dev) drain();
+}
+
+const DisplayDmaStats &getDisplayDmaStats() {
+  return s_stats;
+}
+
+// -------------------------- St7789Dma --------------------------
+bool St7789Dma::beginDma(int8_t sck, int8_t mosi, uint32_t hz, uint8_t spiMode) {
+  sck_ = sck; mosi_ = mosi; hz_ = hz; mode_ = spiMode;
+  SPI.end();
+  dma_ = dtStart(sck, mosi, _cs, _dc, hz, spiMode);
+  if (!dma_) {
+    SPI.begin(sck, -1, mosi);
+    Serial.println("DisplayDmaUtils: staying on blocking SPI");
+    return false;
+  }
+  Serial.printf("DisplayDmaUtils: DMA transport at %lu MHz, 2 x %u px bands\n",
+                (unsigned long)(hz / 1000000UL), DISPLAY_DMA_BAND_PX);
+  return true;
+}
+
+void St7789Dma::suspendDma() {
+  dtStop();
+  dma_ = false;
+  if (_cs >= 0) { pinMode(_cs, OUTPUT); digitalWrite(_cs, HIGH); }
+  SPI.begin(sck_, -1, mosi_);
+}
+
+void St7789Dma::resumeDma() {
+  SPI.end();
+  dma_ = dtStart(sck_, mosi_, _cs, _dc, hz_, mode_);
+  if (!dma_) SPI.begin(sck_, -1, mosi_);
+}
+
+void St7789Dma::setRotation(uint8_t m) {
+  if (!dma_) { Adafruit_ST7789::setRotation(m); return; }
+  suspendDma();
+  Adafruit_ST7789::setRotation(m);
+  resumeDma();
+}
+
+void St7789Dma::invertDisplay(bool i) {
+  if (!dma_) { Adafruit_ST7789::invertDisplay(i); return; }
+  suspendDma();
+  Adafruit_ST7789::invertDisplay(i);
+  resumeDma();
+}
+
+void St7789Dma::startWrite(void) {
+  if (!dma_) { Adafruit_ST7789::startWrite(); return; }
+  depth_++;
+}
+
+void St7789Dma::endWrite(void) {
+  if (!dma_) { Adafruit_ST7789::endWrite(); return; }
+  // let the partial band go out; nothing waits for it
+  if (depth_ > 0 && --depth_ == 0) flushBand();
+}
+
+bool St7789Dma::clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const {
+  if (w < 0) { x += w + 1; w = -w; }
+  if (h < 0) { y += h + 1; h = -h; }
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > _width)  w = _width - x;
+  if (y + h > _height) h = _height - y;
+  return w > 0 && h > 0;
+}
+
+void St7789Dma::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  if (!dma_) { Adafruit_ST7789::setAddrWindow(x, y, w, h); return; }
+  uint16_t x0 = x + _xstart, y0 = y + _ystart;
+  dtWindow(x0, y0, x0 + w - 1, y0 + h - 1);
+}
+
+void St7789Dma::writePixels(uint16_t *colors, uint32_t len, bool block, bool bigEndian) {
+  if (!dma_) { Adafruit_ST7789::writePixels(colors, len, block, bigEndian); return; }
+  dtPixels(colors, len, bigEndian); // copied: the caller's buffer is free on return
+}
+
+void St7789Dma::writeColor(uint16_t color, uint32_t len) {
+  if (!dma_) { Adafruit_ST7789::writeColor(color, len); return; }
+  dtColor(color, len);
+}
+
+void St7789Dma::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if (!dma_) { Adafruit_ST7789::writePixel(x, y, color); return; }
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  setAddrWindow(x, y, 1, 1);
+  dtColor(color, 1);
+}
+
+void St7789Dma::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (!dma_) { Adafruit_ST7789::writeFillRect(x, y, w, h, color); return; }
+  if (!clipRect(x, y, w, h)) return;
+  setAddrWindow(x, y, w, h);
+  dtColor(color, (uint32_t)w * h);
+}
+
+void St7789Dma::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  if (!dma_) { Adafruit_ST7789::writeFastHLine(x, y, w, color); return; }
+  writeFillRect(x, y, w, 1, color);
+}
+
+void St7789Dma::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  if (!dma_) { Adafruit_ST7789::writeFastVLine(x, y, h, color); return; }
+  writeFillRect(x, y, 1, h, color);
+}
+
+void St7789Dma::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!dma_) { Adafruit_ST7789::drawPixel(x, y, color); return; }
+  startWrite();
+  writePixel(x, y, color);
+  endWrite();
+}
+
+void St7789Dma::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (!dma_) { Adafruit_ST7789::fillRect(x, y, w, h, color); return; }
+  startWrite();
+  writeFillRect(x, y, w, h, color);
+  endWrite();
+}
+
+void St7789Dma::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  if (!dma_) { Adafruit_ST7789::drawFastHLine(x, y, w, color); return; }
+  startWrite();
+  writeFillRect(x, y, w, 1, color);
+  endWrite();
+}
+
+void St7789Dma::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  if (!dma_) { Adafruit_ST7789::drawFastVLine(x, y, h, color); return; }
+  startWrite();
+  writeFillRect(x, y, 1, h, color);
+  endWrite();
+}
+
+void St7789Dma::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h) {
+  if (!dma_) { Adafruit_ST7789::drawRGBBitmap(x, y, pcolors, w, h); return; }
+  int16_t x2, y2;
+  if ((x >= _width) || (y >= _height) || ((x2 = (x + w - 1)) < 0) || ((y2 = (y + h - 1)) < 0)) return;
+  int16_t bx1 = 0, by1 = 0, saveW = w;
+  if (x < 0) { w += x; bx1 = -x; x = 0; }
+  if (y < 0) { h += y; by1 = -y; y = 0; }
+  if (x2 >= _width)  w = _width - x;
+  if (y2 >= _height) h = _height - y;
+  pcolors += by1 * saveW + bx1;
+  startWrite();
+  setAddrWindow(x, y, w, h);
+  while (h--) {
+    dtPixels(pcolors, w, false);
+    pcolors += saveW;
+  }
+  endWrite();
+}
+
+// -------------------------- benchmark --------------------------
+// Cheap per-pixel work so the CPU side of each band is not free
+static void renderBand(uint16_t *dst, int w, int y0, int rows, int frame, bool swapped) {
+  for (int r = 0; r < rows; ++r) {
+    for (int x = 0; x < w; ++x) {
+      uint16_t c = (uint16_t)((((x + frame * 5) & 0x1F) << 11) | (((y0 + r) & 0x3F) << 5) | (frame & 0x1F));
+      *dst++ = swapped ? displayDmaSwap(c) : c;
+    }
+  }
+}
+
+void St7789Dma::benchmark(int frames) {
+  static uint16_t staging[DISPLAY_DMA_BAND_PX];
+  int rows = DISPLAY_DMA_BAND_PX / _width;
+  if (rows < 1 || frames < 1) return;
+  uint32_t bytes = (uint32_t)_width * _height * 2 * frames;
+
+  // current path: render a band, then push it with the blocking Arduino SPI driver
+  bool wasDma = dma_;
+  if (wasDma) suspendDma();
+  uint32_t t0 = micros();
+  for (int f = 0; f < frames; ++f) {
+    for (int y = 0; y < _height; y += rows) {
+      int h = min(rows, (int)_height - y);
+      renderBand(staging, _width, y, h, f, false);
+      Adafruit_ST7789::drawRGBBitmap(0, y, staging, _width, h);
+    }
+  }
+  uint32_t tBlock = micros() - t0;
+  if (wasDma) resumeDma();
+  Serial.printf("DisplayDmaUtils: blocking %lu us/frame, %.2f MB/s\n",
+                (unsigned long)(tBlock / frames), bytes / (float)tBlock);
+  if (!dma_) return;
+
+  // DMA path: render straight into the free band while the other one transmits
+  t0 = micros();
+  for (int f = 0; f < frames; ++f) {
+    for (int y = 0; y < _height; y += rows) {
+      int h = min(rows, (int)_height - y);
+      startWrite();
+      setAddrWindow(0, y, _width, h);
+      uint32_t cap = 0;
+      uint16_t *band = displayDmaBandBegin(&cap);
+      renderBand(band, _width, y, h, f, true);
+      displayDmaBandCommit((uint32_t)_width * h);
+      endWrite();
+    }
+  }
+  displayDmaWaitIdle();
+  uint32_t tDma = micros() - t0;
+  Serial.printf("DisplayDmaUtils: DMA      %lu us/frame, %.2f MB/s (%.1fx)\n",
+                (unsigned long)(tDma / frames), bytes / (float)tDma, tBlock / (float)tDma);
+}
+
+#endif // ARDUINO_ARCH_ESP32 && DISPLAY_DMA
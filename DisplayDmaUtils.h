@@ -0,0 +1,100 @@
+#ifndef DISPLAYDMAUTILS_H
+#define DISPLAYDMAUTILS_H
+
+#include <Arduino.h>
+#include <Adafruit_ST7789.h>
+
+/*
+  DisplayDmaUtils - queued DMA transport for the ST7789 (ESP32-S3 SPI3 + GDMA)
+  - Pixels are byte-swapped into one of two DMA-capable band buffers. A full band is
+    queued to the SPI peripheral and the CPU goes on filling the other band while it
+    transmits (ping-pong). Window commands are queued in the same order, so drawing
+    needs no extra synchronisation.
+  - Tiny windows (single pixels, short runs: <= DISPLAY_DMA_SMALL_PX) go out as polling
+    transactions after the queue drains; an interrupt per 2-byte transfer would cost
+    more than the blocking write.
+  - St7789Dma overrides the Adafruit_SPITFT primitives, so GFX code (fillRect, lines,
+    text, drawRGBBitmap) runs on top unchanged. The init sequence still goes through
+    the blocking Arduino SPI driver; beginDma() takes the bus over afterwards.
+  - displayDmaFence(cb, arg) runs cb once everything queued so far has left the bus.
+    Callbacks run from the drawing task (waits / displayDmaPoll()), never from an ISR,
+    and must not draw.
+  Set DISPLAY_DMA to 0 to keep the stock blocking driver (host builds always do).
+*/
+
+#ifndef DISPLAY_DMA
+#define DISPLAY_DMA 1
+#endif
+
+const uint16_t DISPLAY_DMA_BAND_PX  = 2048;  // pixels per band (2 bands x 4 KB)
+const uint16_t DISPLAY_DMA_SMALL_PX = 32;    // windows up to this size are polled
+
+struct DisplayDmaStats {
+  uint32_t bands;     // pixel transactions queued
+  uint32_t bytes;     // pixel bytes queued
+  uint32_t polled;    // polling transactions (commands and data of small windows)
+  uint32_t waitUs;    // CPU time spent waiting for a free band, queue slot or idle bus
+};
+
+#if defined(ARDUINO_ARCH_ESP32) && DISPLAY_DMA
+
+class St7789Dma : public Adafruit_ST7789 {
+public:
+  St7789Dma(int8_t cs, int8_t dc, int8_t rst) : Adafruit_ST7789(cs, dc, rst) {}
+
+  // Switch from the Arduino SPI driver to the DMA transport (after init()/setRotation()).
+  // Returns false and stays on the blocking driver if the SPI3 bus cannot be set up.
+  bool beginDma(int8_t sck, int8_t mosi, uint32_t hz = 40000000, uint8_t spiMode = 0);
+  bool dmaActive() const { return dma_; }
+
+  // Rare commands are sent through the stock driver (bus handed back temporarily)
+  void setRotation(uint8_t m) override;
+  void invertDisplay(bool i) override;
+
+  // Adafruit_SPITFT primitives, routed through the DMA transport
+  void startWrite(void) override;
+  void endWrite(void) override;
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) override;
+  void writePixels(uint16_t *colors, uint32_t len, bool block = true, bool bigEndian = false);
+  void writeColor(uint16_t color, uint32_t len);
+  using Adafruit_GFX::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h);
+
+  // Times full-screen pushes on the stock blocking path and on the DMA path (Serial)
+  void benchmark(int frames = 10);
+
+private:
+  bool clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const;
+  void suspendDma();
+  void resumeDma();
+
+  bool     dma_ = false;
+  int      depth_ = 0;
+  int8_t   sck_ = -1, mosi_ = -1;
+  uint32_t hz_ = 40000000;
+  uint8_t  mode_ = 0;
+};
+
+// Zero-copy band access for render code: after setAddrWindow(), fill up to *capacity
+// big-endian pixels (displayDmaSwap()) into the returned band and commit them; the
+// band is transmitted while the next one is filled.
+uint16_t *displayDmaBandBegin(uint32_t *capacity);
+void displayDmaBandCommit(uint32_t pixels);
+inline uint16_t displayDmaSwap(uint16_t c) { return (uint16_t)((c << 8) | (c >> 8)); }
+
+void displayDmaFence(void (*cb)(void *), void *arg);
+void displayDmaPoll();       // run callbacks of finished transfers (non-blocking)
+void displayDmaWaitIdle();   // queue the partial band and wait until the bus is idle
+const DisplayDmaStats &getDisplayDmaStats();
+
+#endif // ARDUINO_ARCH_ESP32 && DISPLAY_DMA
+
+#endif // DISPLAYDMAUTILS_H
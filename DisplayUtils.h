@@ -0,0 +1,32 @@
+#ifndef DISPLAYUTILS_H
+#define DISPLAYUTILS_H
+
+#include <Adafruit_ST7789.h>
+#include "DisplayDmaUtils.h"
+#include "FramebufferUtils.h"
+
+// The panel (defined in the main sketch): init, rotation and the transport.
+// On the ESP32 with DISPLAY_DMA it is the DMA-backed subclass, otherwise the stock driver.
+#if defined(ARDUINO_ARCH_ESP32) && DISPLAY_DMA
+typedef St7789Dma DisplayDriver;
+#else
+typedef Adafruit_ST7789 DisplayDriver;
+#endif
+
+extern DisplayDriver tft;
+
+// What the drawing modules draw into: the indexed framebuffer (DISPLAY_FRAMEBUFFER),
+// or the panel itself. Defined in the main sketch.
+#if DISPLAY_FRAMEBUFFER
+typedef IndexedFramebuffer DisplaySurface;
+#else
+typedef DisplayDriver DisplaySurface;
+#endif
+
+extern DisplaySurface &screen;
+
+// Pushes the framebuffer regions drawn since the last call to the panel
+// (no-op when drawing straight to the panel)
+void displayFlush();
+
+#endif // DISPLAYUTILS_H
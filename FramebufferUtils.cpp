@@ -0,0 +1,244 @@
+#include "FramebufferUtils.h"
+#include "DisplayUtils.h"   // tft (panel), screen, displayFlush()
+#include <limits.h>
+
+#if DISPLAY_FB_BPP == 4
+static uint8_t s_pixels[(DISPLAY_FB_W * DISPLAY_FB_H + 1) / 2];   // two pixels per byte, high nibble first
+#else
+static uint8_t s_pixels[DISPLAY_FB_W * DISPLAY_FB_H];
+#endif
+
+static inline uint8_t getIndex(int16_t x, int16_t y) {
+  uint32_t i = (uint32_t)y * DISPLAY_FB_W + x;
+#if DISPLAY_FB_BPP == 4
+  uint8_t b = s_pixels[i >> 1];
+  return (i & 1) ? (b & 0x0F) : (b >> 4);
+#else
+  return s_pixels[i];
+#endif
+}
+
+// Writes n pixels of one row
+static inline void setRow(int16_t x, int16_t y, int16_t n, uint8_t idx) {
+  uint32_t i = (uint32_t)y * DISPLAY_FB_W + x;
+#if DISPLAY_FB_BPP == 4
+  uint32_t end = i + n;
+  if ((i & 1) && i < end) { s_pixels[i >> 1] = (s_pixels[i >> 1] & 0xF0) | idx; ++i; }
+  uint32_t pairs = (end - i) >> 1;
+  if (pairs) memset(&s_pixels[i >> 1], (idx << 4) | idx, pairs);
+  i += pairs << 1;
+  if (i < end) s_pixels[i >> 1] = (s_pixels[i >> 1] & 0x0F) | (idx << 4);
+#else
+  memset(&s_pixels[i], idx, n);
+#endif
+}
+
+IndexedFramebuffer::IndexedFramebuffer(int16_t w, int16_t h)
+    : Adafruit_GFX(min(w, DISPLAY_FB_W), min(h, DISPLAY_FB_H)) {
+  for (int s = 0; s < DISPLAY_FB_STRIPS; ++s) { dirtyX0_[s] = 0; dirtyX1_[s] = 0; }
+  palette_[0] = 0x0000;   // index 0 = black, the content of a cleared buffer
+  paletteBE_[0] = 0x0000;
+  paletteUsed_ = 1;
+}
+
+uint8_t IndexedFramebuffer::colorIndex(uint16_t color) {
+  if (lastValid_ && color == lastColor_) return lastIndex_;
+  int found = -1;
+  for (int i = 0; i < paletteUsed_; ++i) {
+    if (palette_[i] == color) { found = i; break; }
+  }
+  if (found < 0 && paletteUsed_ < DISPLAY_FB_COLORS) {
+    found = paletteUsed_++;
+    palette_[found] = color;
+    paletteBE_[found] = (uint16_t)((color << 8) | (color >> 8));
+    stats_.colors = (uint8_t)min(paletteUsed_, 255);
+  }
+  if (found < 0) {
+    // palette full: nearest entry by squared RGB distance (5/6/5 bits)
+    stats_.misses++;
+    long best = LONG_MAX;
+    int r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+    for (int i = 0; i < paletteUsed_; ++i) {
+      uint16_t p = palette_[i];
+      long dr = r - (p >> 11), dg = g - ((p >> 5) & 0x3F), db = b - (p & 0x1F);
+      long d = 4 * dr * dr + dg * dg + 4 * db * db;
+      if (d < best) { best = d; found = i; }
+    }
+  }
+  lastColor_ = color;
+  lastIndex_ = (uint8_t)found;
+  lastValid_ = true;
+  return lastIndex_;
+}
+
+bool IndexedFramebuffer::clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const {
+  if (w < 0) { x += w + 1; w = -w; }
+  if (h < 0) { y += h + 1; h = -h; }
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > _width)  w = _width - x;
+  if (y + h > _height) h = _height - y;
+  return w > 0 && h > 0;
+}
+
+void IndexedFramebuffer::markDirty(int16_t x, int16_t y, int16_t w, int16_t h) {
+  int s0 = y / DISPLAY_FB_STRIP, s1 = (y + h - 1) / DISPLAY_FB_STRIP;
+  for (int s = s0; s <= s1; ++s) {
+    if (dirtyX0_[s] >= dirtyX1_[s]) { dirtyX0_[s] = x; dirtyX1_[s] = x + w; continue; }
+    if (x < dirtyX0_[s]) dirtyX0_[s] = x;
+    if (x + w > dirtyX1_[s]) dirtyX1_[s] = x + w;
+  }
+}
+
+void IndexedFramebuffer::markAllDirty() {
+  markDirty(0, 0, _width, _height);
+}
+
+void IndexedFramebuffer::fillIndex(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t idx) {
+  if (!clipRect(x, y, w, h)) return;
+  for (int16_t row = y; row < y + h; ++row) setRow(x, row, w, idx);
+  markDirty(x, y, w, h);
+}
+
+void IndexedFramebuffer::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  setRow(x, y, 1, colorIndex(color));
+  markDirty(x, y, 1, 1);
+}
+
+void IndexedFramebuffer::writePixel(int16_t x, int16_t y, uint16_t color) {
+  drawPixel(x, y, color);
+}
+
+void IndexedFramebuffer::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  fillIndex(x, y, w, h, colorIndex(color));
+}
+
+void IndexedFramebuffer::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillIndex(x, y, w, 1, colorIndex(color));
+}
+
+void IndexedFramebuffer::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillIndex(x, y, 1, h, colorIndex(color));
+}
+
+void IndexedFramebuffer::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  fillIndex(x, y, w, h, colorIndex(color));
+}
+
+void IndexedFramebuffer::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillIndex(x, y, w, 1, colorIndex(color));
+}
+
+void IndexedFramebuffer::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillIndex(x, y, 1, h, colorIndex(color));
+}
+
+void IndexedFramebuffer::fillScreen(uint16_t color) {
+  fillIndex(0, 0, _width, _height, colorIndex(color));
+}
+
+void IndexedFramebuffer::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h) {
+  int16_t cx = x, cy = y, cw = w, ch = h;
+  if (!clipRect(cx, cy, cw, ch)) return;
+  for (int16_t row = cy; row < cy + ch; ++row) {
+    const uint16_t *src = pcolors + (row - y) * w + (cx - x);
+    for (int16_t col = 0; col < cw; ++col) setRow(cx + col, row, 1, colorIndex(src[col]));
+  }
+  markDirty(cx, cy, cw, ch);
+}
+
+uint16_t IndexedFramebuffer::pixelAt(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return 0;
+  return palette_[getIndex(x, y)];
+}
+
+bool IndexedFramebuffer::takeDirtyRun(int16_t &x0, int16_t &y0, int16_t &x1, int16_t &y1) {
+  int s = 0;
+  while (s < DISPLAY_FB_STRIPS && dirtyX0_[s] >= dirtyX1_[s]) ++s;
+  if (s == DISPLAY_FB_STRIPS) return false;
+  // consecutive dirty strips go out as one window (union of their spans)
+  x0 = dirtyX0_[s];
+  x1 = dirtyX1_[s];
+  y0 = s * DISPLAY_FB_STRIP;
+  for (; s < DISPLAY_FB_STRIPS && dirtyX0_[s] < dirtyX1_[s]; ++s) {
+    if (dirtyX0_[s] < x0) x0 = dirtyX0_[s];
+    if (dirtyX1_[s] > x1) x1 = dirtyX1_[s];
+    dirtyX0_[s] = dirtyX1_[s] = 0;
+  }
+  y1 = min((int16_t)(s * DISPLAY_FB_STRIP), _height);
+  return true;
+}
+
+void IndexedFramebuffer::expandRow(int16_t x, int16_t y, int16_t n, uint16_t *out, bool bigEndian) const {
+  const uint16_t *pal = bigEndian ? paletteBE_ : palette_;
+#if DISPLAY_FB_BPP == 4
+  for (int16_t i = 0; i < n; ++i) out[i] = pal[getIndex(x + i, y)];
+#else
+  const uint8_t *src = &s_pixels[(uint32_t)y * DISPLAY_FB_W + x];
+  for (int16_t i = 0; i < n; ++i) out[i] = pal[src[i]];
+#endif
+}
+
+// -------------------------- flush --------------------------
+#if DISPLAY_FRAMEBUFFER
+
+// One window: palette-expanded straight into the DMA bands, or through a line buffer
+static void pushWindow(IndexedFramebuffer &fb, int16_t x0, int16_t y0, int16_t w, int16_t h) {
+  tft.startWrite();
+  tft.setAddrWindow(x0, y0, w, h);
+  int16_t row = y0, col = 0;            // next pixel to send
+  uint32_t left = (uint32_t)w * h;
+  while (left > 0) {
+#if defined(ARDUINO_ARCH_ESP32) && DISPLAY_DMA
+    uint32_t cap = 0;
+    uint16_t *band = tft.dmaActive() ? displayDmaBandBegin(&cap) : nullptr;
+    if (band && cap > 0) {
+      uint32_t k = left < cap ? left : cap;
+      uint32_t done = 0;
+      while (done < k) {
+        int16_t n = (int16_t)min((uint32_t)(w - col), k - done);
+        fb.expandRow(x0 + col, row, n, band + done, true);
+        done += n;
+        col += n;
+        if (col == w) { col = 0; ++row; }
+      }
+      displayDmaBandCommit(k);
+      left -= k;
+      continue;
+    }
+#endif
+    // blocking driver (or a window small enough to be polled): one row segment at a time
+    static uint16_t line[DISPLAY_FB_W];
+    int16_t n = w - col;
+    fb.expandRow(x0 + col, row, n, line, false);
+    tft.writePixels(line, n, true, false);
+    left -= n;
+    col = 0;
+    ++row;
+  }
+  tft.endWrite();
+}
+
+void displayFlush() {
+  IndexedFramebuffer &fb = screen;
+  int16_t x0, y0, x1, y1;
+  uint32_t t0 = micros();
+  bool any = false;
+  while (fb.takeDirtyRun(x0, y0, x1, y1)) {
+    pushWindow(fb, x0, y0, x1 - x0, y1 - y0);
+    fb.stats().windows++;
+    fb.stats().pixels += (uint32_t)(x1 - x0) * (y1 - y0);
+    any = true;
+  }
+  if (any) {
+    fb.stats().flushes++;
+    fb.stats().lastUs = micros() - t0;
+  }
+}
+
+#else
+
+void displayFlush() {}
+
+#endif // DISPLAY_FRAMEBUFFER
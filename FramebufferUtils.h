@@ -0,0 +1,91 @@
+#ifndef FRAMEBUFFERUTILS_H
+#define FRAMEBUFFERUTILS_H
+
+#include <Arduino.h>
+#include <Adafruit_GFX.h>
+
+/*
+  FramebufferUtils - indexed-color full-screen framebuffer (320x170)
+  - The UI modules draw into IndexedFramebuffer (an Adafruit_GFX) instead of the
+    panel: 1 byte per pixel (54 KB) or, with DISPLAY_FB_BPP 4, a nibble (27 KB).
+    The buffer is a static array, so it always lands in internal SRAM.
+  - RGB565 colors are mapped to palette entries on first use (the UI needs about a
+    dozen). When the palette is full, the nearest entry is used.
+  - Drawing only marks strips of DISPLAY_FB_STRIP rows dirty. displayFlush() (see
+    DisplayUtils.h) pushes each run of dirty strips as one window, expanding indices
+    through the palette as the bands are filled - straight into the DMA bands on the
+    ESP32 - so the panel only ever shows fully composed frames.
+  Set DISPLAY_FRAMEBUFFER to 0 to draw straight to the panel again.
+*/
+
+#ifndef DISPLAY_FRAMEBUFFER
+#define DISPLAY_FRAMEBUFFER 1
+#endif
+
+#ifndef DISPLAY_FB_BPP
+#define DISPLAY_FB_BPP 8     // 8 (256 colors) or 4 (16 colors)
+#endif
+
+const int16_t DISPLAY_FB_W = 320;
+const int16_t DISPLAY_FB_H = 170;
+const int16_t DISPLAY_FB_STRIP = 10;   // rows per dirty-tracking strip
+const int16_t DISPLAY_FB_STRIPS = (DISPLAY_FB_H + DISPLAY_FB_STRIP - 1) / DISPLAY_FB_STRIP;
+const int     DISPLAY_FB_COLORS = 1 << DISPLAY_FB_BPP;
+
+struct FramebufferStats {
+  uint32_t flushes;     // displayFlush() calls that pushed something
+  uint32_t windows;     // address windows sent
+  uint32_t pixels;      // pixels expanded and sent
+  uint32_t lastUs;      // duration of the last flush that pushed something
+  uint8_t  colors;      // palette entries in use
+  uint32_t misses;      // colors that did not fit the palette (drawn as nearest)
+};
+
+class IndexedFramebuffer : public Adafruit_GFX {
+public:
+  IndexedFramebuffer(int16_t w, int16_t h);   // at most DISPLAY_FB_W x DISPLAY_FB_H
+
+  // Adafruit_GFX primitives (indices are written, colors are mapped once per call)
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillScreen(uint16_t color) override;
+  using Adafruit_GFX::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h);
+
+  uint16_t pixelAt(int16_t x, int16_t y) const;   // RGB565 (for tests / screenshots)
+  uint8_t colorIndex(uint16_t color);             // palette slot for a color (adds it)
+  void markAllDirty();
+
+  // Dirty runs for the flush: [x0, x1) x [y0, y1); clears them. False when clean.
+  bool takeDirtyRun(int16_t &x0, int16_t &y0, int16_t &x1, int16_t &y1);
+  // Expands n pixels of row y starting at x to RGB565 (bigEndian: byte-swapped for SPI)
+  void expandRow(int16_t x, int16_t y, int16_t n, uint16_t *out, bool bigEndian) const;
+
+  const FramebufferStats &stats() const { return stats_; }
+  FramebufferStats &stats() { return stats_; }
+
+private:
+  bool clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const;
+  void fillIndex(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t idx);
+  void markDirty(int16_t x, int16_t y, int16_t w, int16_t h);
+
+  uint16_t palette_[DISPLAY_FB_COLORS];
+  uint16_t paletteBE_[DISPLAY_FB_COLORS];   // byte-swapped copy for the DMA bands
+  int      paletteUsed_ = 0;
+  uint16_t lastColor_ = 0;
+  uint8_t  lastIndex_ = 0;
+  bool     lastValid_ = false;
+
+  int16_t dirtyX0_[DISPLAY_FB_STRIPS];      // x0 >= x1 means clean
+  int16_t dirtyX1_[DISPLAY_FB_STRIPS];
+
+  FramebufferStats stats_ = {};
+};
+
+#endif // FRAMEBUFFERUTILS_H
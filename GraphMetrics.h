@@ -0,0 +1,106 @@
+#ifndef GRAPH_METRICS_H
+#define GRAPH_METRICS_H
+
+#include <Arduino.h>
+#include <Adafruit_ST7789.h> // ST77XX_* colors
+#include <math.h>
+#include "WeatherUtils.h"    // ForecastSlot
+#include "HistoryUtils.h"    // HistorySample
+
+/*
+  GraphMetrics - compile-time descriptors for the graphs drawn by GraphUtils
+  A metric is a struct of static members; GraphUtils instantiates its resample and
+  render code once per metric, so the per-point loops call these inline (no switch):
+    title()        graph title, units included
+    color()        line color (RGB565)
+    forecast(s)    ForecastSlot value in plot units (NAN = missing)
+    observed(h)    HistorySample value in plot units (NAN = missing)
+    Axis           range policy: AxisPadded or AxisBounded<lo, hi>
+    Label          text policy: LabelDecimal or LabelPercent
+  Adding a graph = one struct appended to GraphMetricList; NUM_GRAPHS follows.
+*/
+
+// ----- axis policies: data range -> drawn range -----
+struct AxisPadded {
+  static void apply(float &vmin, float &vmax) {
+    float padding = (vmax - vmin) * 0.12f;
+    if (padding <= 0.5f) padding = 0.5f;
+    vmin -= padding;
+    vmax += padding;
+  }
+};
+
+// Padded, but kept inside a physical range (e.g. 0..100 for percentages)
+template <int LO, int HI>
+struct AxisBounded {
+  static void apply(float &vmin, float &vmax) {
+    AxisPadded::apply(vmin, vmax);
+    if (vmin < LO) vmin = LO;
+    if (vmax > HI) vmax = HI;
+    if (vmax - vmin < 1.0f) {
+      if (vmin + 1.0f <= HI) vmax = vmin + 1.0f;
+      else vmin = vmax - 1.0f;
+    }
+  }
+};
+
+// ----- label policies: axis ticks (fine) and min/max tags (whole numbers) -----
+// Buffer for a tick label: "%g" of any double ("-1.23457e+308") plus the NUL fits
+const size_t LABEL_TICK_LEN = 16;
+
+struct LabelDecimal {
+  static void tick(char *buf, size_t n, float v)  { snprintf(buf, n, "%g", round(v * 10) / 10.0); }
+  static void whole(char *buf, size_t n, float v) { snprintf(buf, n, "%.0f", round(v)); }
+};
+
+struct LabelPercent {
+  static void tick(char *buf, size_t n, float v)  { snprintf(buf, n, "%d%%", (int)round(v)); }
+  static void whole(char *buf, size_t n, float v) { snprintf(buf, n, "%d%%", (int)round(v)); }
+};
+
+// ----- metrics -----
+struct MetricTemp {
+  typedef AxisPadded   Axis;
+  typedef LabelDecimal Label;
+  static const char *title() { return "Temperature (F)"; }
+  static uint16_t color()    { return ST77XX_RED; }
+  static float forecast(const ForecastSlot &s)  { return s.temp; }
+  static float observed(const HistorySample &h) { return h.temp; }
+};
+
+struct MetricWind {
+  typedef AxisPadded   Axis;
+  typedef LabelDecimal Label;
+  static const char *title() { return "Wind (mph)"; }
+  static uint16_t color()    { return ST77XX_CYAN; }
+  static float forecast(const ForecastSlot &s)  { return s.wind; }
+  static float observed(const HistorySample &h) { return h.wind; }
+};
+
+struct MetricPop {
+  typedef AxisBounded<0, 100> Axis;
+  typedef LabelPercent        Label;
+  static const char *title() { return "Precip %"; }
+  static uint16_t color()    { return ST77XX_YELLOW; }
+  static float forecast(const ForecastSlot &s)  { return s.pop * 100.0f; } // 0..1 -> percent
+  static float observed(const HistorySample &h) { return h.pop * 100.0f; }
+};
+
+struct MetricHumidity {
+  typedef AxisBounded<0, 100> Axis;
+  typedef LabelPercent        Label;
+  static const char *title() { return "Humidity %"; }
+  static uint16_t color()    { return ST77XX_GREEN; }
+  static float forecast(const ForecastSlot &s)  { return s.humidity < 0 ? NAN : (float)s.humidity; }
+  static float observed(const HistorySample &h) { return h.humidity < 0 ? NAN : (float)h.humidity; }
+};
+
+template <class... Ms>
+struct MetricList {
+  static const int count = sizeof...(Ms);
+};
+
+// Rotation order of drawGraph(graphType): 0 = temp, 1 = wind, 2 = pop, 3 = humidity
+typedef MetricList<MetricTemp, MetricWind, MetricPop, MetricHumidity> GraphMetricList;
+
+#endif // GRAPH_METRICS_H
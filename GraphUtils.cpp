@@ -1,83 +1,167 @@
 #include "GraphUtils.h"
-#include "WeatherUtils.h"      // for getCachedForecastRaw()
+#include "WeatherUtils.h"      // for getWeatherSnapshot()
+#include "HistoryUtils.h"      // observed samples for the overlay
+#include "TextUtils.h"         // textDrawTransparent() for labels
 #include <Arduino.h>
-#include <ArduinoJson.h>
 #include <time.h>
 #include <Adafruit_GFX.h>
 #include <Adafruit_ST7789.h>
 #include <math.h>
 
 // Extern TFT object declared in main sketch
-extern Adafruit_ST7789 tft;
+#include "DisplayUtils.h"  // extern DisplaySurface &screen
 
 // Exported arrays (defined here)
-float graphTemp[GRAPH_HOURS];
-float graphWind[GRAPH_HOURS];
-float graphPop[GRAPH_HOURS];
 bool  graphValid[GRAPH_HOURS];
 int   graphHourLabels[GRAPH_HOURS];
 
 // Graph area state
 static int g_x = 0, g_y = 0, g_w = 0, g_h = 0;
 
-// Colors (tweak as desired)
+// Per-metric plot series and value range, fixed when the data is calculated (not per draw)
+static float s_series[NUM_GRAPHS][GRAPH_HOURS];
+static float s_rangeMin[NUM_GRAPHS], s_rangeMax[NUM_GRAPHS];
+static bool  s_rangeValid[NUM_GRAPHS];
+
+// Point table: plot range after the metric's axis policy, x per hour (shared) and y per
+// metric and hour. Rebuilt when the data or the area changes; drawGraph() and the morph
+// frames only read it.
+static const int16_t NO_POINT = INT16_MIN;
+static float   s_plotMin[NUM_GRAPHS], s_plotMax[NUM_GRAPHS];
+static int16_t s_px[GRAPH_HOURS];
+static int16_t s_py[NUM_GRAPHS][GRAPH_HOURS];
+
+// Colors (tweak as desired; metric line colors live in GraphMetrics.h)
 static const uint16_t COL_BG      = ST77XX_BLACK;
 static const uint16_t COL_AXIS    = ST77XX_WHITE;
 static const uint16_t COL_GRID    = 0x4208; // dim grey
-static const uint16_t COL_TEMP    = ST77XX_RED;
-static const uint16_t COL_WIND    = ST77XX_CYAN;
-static const uint16_t COL_POP     = ST77XX_YELLOW;
 static const uint16_t COL_MARKER  = ST77XX_MAGENTA;
 static const uint16_t COL_TEXT    = ST77XX_WHITE;
+static const uint16_t COL_OBSERVED = 0xBDF7; // light grey: recorded observations
+static const int16_t  CAP_R = 2;               // point dot radius
+
+static const int GRAPH_GRID_LINES = 4;
+static const int MAJOR_TICKS24[] = {9,12,15,18,21};
+static const int NUM_MAJOR_TICKS = sizeof(MAJOR_TICKS24) / sizeof(MAJOR_TICKS24[0]);
+
+// Target hour -> pair of forecast slots and interpolation weight (shared by all metrics)
+struct HourMap {
+  int    idx0, idx1;
+  double alpha;
+};
 
 // Forward declarations of locals used earlier
 static float lerpFloat(float a, float b, double t);
 static void smoothArray(float *arr, bool *valid, int n);
+static bool findMinMax(const float *arr, const bool *valid, int n, float &minV, float &maxV);
+
+// -------------------------- per-metric pipeline --------------------------
+// Instantiated once per metric trait: the loops below call the trait inline.
+template <class M>
+static void resampleMetric(const WeatherSnapshot &snap, const HourMap *map, float *out) {
+  for (int i = 0; i < GRAPH_HOURS; ++i) {
+    // interpolate if both sides exist; if NaN on one side, pick the other
+    float v0 = M::forecast(snap.slots[map[i].idx0]);
+    float v1 = M::forecast(snap.slots[map[i].idx1]);
+    if (!isnan(v0) && !isnan(v1)) out[i] = lerpFloat(v0, v1, map[i].alpha);
+    else out[i] = isnan(v0) ? v1 : v0;
+  }
+}
+
+template <class M>
+static void printSeries(const float *series) {
+  Serial.printf(" %-16s", M::title());
+  for (int i = 0; i < GRAPH_HOURS; ++i) {
+    char buf[LABEL_TICK_LEN] = "NaN";
+    if (graphValid[i] && !isnan(series[i])) M::Label::tick(buf, sizeof(buf), series[i]);
+    Serial.printf(" %5s", buf);
+  }
+  Serial.println();
+}
+
+static int16_t plotY(float v, float vmin, float vmax) {
+  float fracY = (v - vmin) / (vmax - vmin);
+  if (fracY < 0) fracY = 0;
+  if (fracY > 1) fracY = 1;
+  return (int16_t)(g_y + (g_h - 1) - (int)round(fracY * (g_h - 1)));
+}
+
+// Plot range and point rows of one metric (from the series and range found with the data)
+template <class M>
+static void planMetric(int g) {
+  float vmin = s_rangeMin[g], vmax = s_rangeMax[g];
+  M::Axis::apply(vmin, vmax);
+  if (vmin == vmax) { vmin -= 1.0f; vmax += 1.0f; }
+  s_plotMin[g] = vmin;
+  s_plotMax[g] = vmax;
+  for (int i = 0; i < GRAPH_HOURS; ++i) {
+    bool has = s_rangeValid[g] && graphValid[i] && !isnan(s_series[g][i]);
+    s_py[g][i] = has ? plotY(s_series[g][i], vmin, vmax) : NO_POINT;
+  }
+}
+
+template <class M> static void drawMetric(int g);
+template <class M> static void drawObservedOverlay(float vmin, float vmax);
+
+// Function tables indexed by graphType, expanded from GraphMetricList
+typedef void (*ResampleFn)(const WeatherSnapshot &, const HourMap *, float *);
+typedef void (*SeriesFn)(const float *);
+typedef void (*PlanFn)(int);
+typedef void (*DrawFn)(int);
+typedef uint16_t (*ColorFn)();
+
+template <class L> struct MetricTable;
+template <class... Ms> struct MetricTable<MetricList<Ms...> > {
+  static const ResampleFn resample[sizeof...(Ms)];
+  static const SeriesFn   print[sizeof...(Ms)];
+  static const PlanFn     plan[sizeof...(Ms)];
+  static const DrawFn     draw[sizeof...(Ms)];
+  static const ColorFn    color[sizeof...(Ms)];
+};
+template <class... Ms>
+const ResampleFn MetricTable<MetricList<Ms...> >::resample[sizeof...(Ms)] = { &resampleMetric<Ms>... };
+template <class... Ms>
+const SeriesFn MetricTable<MetricList<Ms...> >::print[sizeof...(Ms)] = { &printSeries<Ms>... };
+template <class... Ms>
+const PlanFn MetricTable<MetricList<Ms...> >::plan[sizeof...(Ms)] = { &planMetric<Ms>... };
+template <class... Ms>
+const DrawFn MetricTable<MetricList<Ms...> >::draw[sizeof...(Ms)] = { &drawMetric<Ms>... };
+template <class... Ms>
+const ColorFn MetricTable<MetricList<Ms...> >::color[sizeof...(Ms)] = { &Ms::color... };
+typedef MetricTable<GraphMetricList> Graphs;
+
+static void updatePointTables() {
+  for (int i = 0; i < GRAPH_HOURS; ++i) {
+    float fracX = float(i) / float(GRAPH_HOURS - 1);
+    s_px[i] = (int16_t)(g_x + 1 + (int)round(fracX * (g_w - 3))); // inside border
+  }
+  for (int g = 0; g < NUM_GRAPHS; ++g) Graphs::plan[g](g);
+}
 
 // -------------------------- calculateGraphDataFromForecastRaw --------------------------
 bool calculateGraphDataFromForecastRaw(bool smooth) {
   // initialize outputs to invalid
   for (int i = 0; i < GRAPH_HOURS; ++i) {
-    graphTemp[i] = NAN;
-    graphWind[i] = NAN;
-    graphPop[i] = NAN;
     graphValid[i] = false;
     graphHourLabels[i] = 9 + i;
   }
-
-  String raw = getCachedForecastRaw();
-  if (raw.length() < 10) {
-    Serial.println("GraphUtils: No cached forecast JSON available.");
-    return false;
+  for (int g = 0; g < NUM_GRAPHS; ++g) {
+    for (int i = 0; i < GRAPH_HOURS; ++i) s_series[g][i] = NAN;
+    s_rangeValid[g] = false;
   }
 
-  // Parse JSON
-  StaticJsonDocument<8192> doc;
-  DeserializationError err = deserializeJson(doc, raw);
-  if (err) {
-    Serial.print("GraphUtils: JSON parse error: ");
-    Serial.println(err.c_str());
+  // Forecast slots were parsed once at fetch time (or loaded from a relay gateway)
+  const WeatherSnapshot &snap = getWeatherSnapshot();
+  if (!snap.valid) {
+    Serial.println("GraphUtils: No forecast snapshot available.");
+    updatePointTables();
     return false;
   }
     // Debug: which city / timezone did the API return?
-  const char* cityName = doc["city"]["name"] | "n/a";
-  const char* country = doc["city"]["country"] | "n/a";
-  long api_tz = doc["city"]["timezone"] | 0L;
-  double lat = doc["city"]["coord"]["lat"] | 0.0;
-  double lon = doc["city"]["coord"]["lon"] | 0.0;
-  Serial.printf("API city: %s, %s  timezone(sec)=%ld  coord=%.4f,%.4f\n",
-                cityName, country, api_tz, lat, lon);
-
-
-  // Forecast list
-  JsonArray list = doc["list"].as<JsonArray>();
-  if (!list) {
-    Serial.println("GraphUtils: forecast JSON missing 'list' array.");
-    return false;
-  }
+  Serial.printf("API city: %s  timezone(sec)=%ld\n", snap.city, (long)snap.tzOffset);
 
   // timezone offset (seconds) if provided by the API
-  long tz_offset = doc["city"]["timezone"] | 0L;
+  long tz_offset = snap.tzOffset;
 
   // Determine today's midnight in the *city's* local time (use tz_offset returned by API)
   time_t now_t = time(NULL);                // current epoch (system UTC-based)
@@ -89,32 +173,10 @@ bool calculateGraphDataFromForecastRaw(bool smooth) {
 
   //Why: city_now is the current epoch shifted into the city's local timeline. gmtime_r(&city_now, &tm_city) gives the city's broken-down time (hour/min/sec). Subtracting the H/M/S yields the epoch for that city’s midnight. All target_ts = midnight_local + H*3600 are now correct for the city.
 
-
-  // Build a small vector of forecast samples: each has dt (UTC), local_ts, temp, wind, pop
-  struct Sample { long dt; long local_ts; float temp; float wind; float pop; };
-  const int MAX_SAMPLES = 256;
-  Sample samples[MAX_SAMPLES];
-  int sampleCount = 0;
-
-  for (JsonObject item : list) {
-    if (sampleCount >= MAX_SAMPLES) break;
-    long dt = item["dt"] | 0L; // UTC epoch seconds
-    long local_ts = dt + tz_offset; // local epoch seconds
-
-    // read fields
-    float temp = NAN;
-    float wind = NAN;
-    float pop  = NAN;
-    if (item.containsKey("main")) temp = item["main"]["temp"] | NAN;
-    if (item.containsKey("wind")) temp = temp; // noop to avoid warnings
-    wind = item["wind"]["speed"] | NAN;
-    pop = item["pop"] | NAN;
-
-    samples[sampleCount++] = { dt, local_ts, temp, wind, pop };
-  }
-
+  int sampleCount = snap.count;
   if (sampleCount == 0) {
     Serial.println("GraphUtils: No forecast samples found.");
+    updatePointTables();
     return false;
   }
 
@@ -122,8 +184,9 @@ bool calculateGraphDataFromForecastRaw(bool smooth) {
     // ----- DEBUG: print raw forecast samples and mapping -----
   Serial.println("GraphUtils: raw forecast samples (UTC -> local):");
   for (int s = 0; s < sampleCount; ++s) {
-    time_t u = (time_t)samples[s].dt;
-    time_t l = (time_t)samples[s].local_ts;
+    const ForecastSlot &slot = snap.slots[s];
+    time_t u = (time_t)slot.dt;
+    time_t l = (time_t)((long)slot.dt + tz_offset);
     struct tm tm_u, tm_l;
     gmtime_r(&u, &tm_u);      // UTC
     gmtime_r(&l, &tm_l);      // city-local (interpret l as epoch shifted by tz_offset)
@@ -133,9 +196,9 @@ bool calculateGraphDataFromForecastRaw(bool smooth) {
     strftime(bufL, sizeof(bufL), "%Y-%m-%d %H:%M", &tm_l);
 
     char line[160];
-    float t = samples[s].temp;
-    float w = samples[s].wind;
-    float p = samples[s].pop;
+    float t = slot.temp;
+    float w = slot.wind;
+    float p = slot.pop;
     // Use NAN text if needed
     snprintf(line, sizeof(line), " s=%02d UTC=%s local=%s  T=%s W=%s POP=%s",
              s,
@@ -147,25 +210,37 @@ bool calculateGraphDataFromForecastRaw(bool smooth) {
     Serial.println(line);
   }
 
+  // For each target hour H in 9..21, compute target_ts (local) for today's date and
+  // find two samples s0,s1 such that s0.local_ts <= target_ts <= s1.local_ts
   Serial.println("GraphUtils: mapping target hours -> sample indices (and alpha):");
+  HourMap map[GRAPH_HOURS];
   for (int i = 0; i < GRAPH_HOURS; ++i) {
     int H = 9 + i;
     long target_ts = midnight_local + (long)H * 3600L;
     int idx0 = -1, idx1 = -1;
     for (int s = 0; s < sampleCount; ++s) {
-      if (samples[s].local_ts <= target_ts) idx0 = s;
-      if (samples[s].local_ts >= target_ts) { idx1 = s; break; }
+      long local_ts = (long)snap.slots[s].dt + tz_offset;
+      if (local_ts <= target_ts) idx0 = s;
+      if (local_ts >= target_ts) { idx1 = s; break; }
     }
+    // if idx0 == -1 use first sample as both bounds (extrapolate/backfill)
     if (idx0 == -1) idx0 = 0;
+    // if idx1 == -1 use last sample
     if (idx1 == -1) idx1 = sampleCount - 1;
-    long t0 = samples[idx0].local_ts;
-    long t1 = samples[idx1].local_ts;
+    long t0 = (long)snap.slots[idx0].dt + tz_offset;
+    long t1 = (long)snap.slots[idx1].dt + tz_offset;
     double alpha = (t1 == t0) ? 0.0 : double(target_ts - t0) / double(t1 - t0);
+    // clamp alpha
+    if (alpha < 0.0) alpha = 0.0;
+    if (alpha > 1.0) alpha = 1.0;
+    map[i].idx0 = idx0;
+    map[i].idx1 = idx1;
+    map[i].alpha = alpha;
 
     // friendly times for idx0/idx1
     char t0s[32] = "n/a", t1s[32] = "n/a";
-    if (idx0 >= 0) { time_t tmp = (time_t)t0; struct tm tm0; gmtime_r(&tmp, &tm0); strftime(t0s, sizeof(t0s), "%H:%M", &tm0); }
-    if (idx1 >= 0) { time_t tmp = (time_t)t1; struct tm tm1; gmtime_r(&tmp, &tm1); strftime(t1s, sizeof(t1s), "%H:%M", &tm1); }
+    { time_t tmp = (time_t)t0; struct tm tm0; gmtime_r(&tmp, &tm0); strftime(t0s, sizeof(t0s), "%H:%M", &tm0); }
+    { time_t tmp = (time_t)t1; struct tm tm1; gmtime_r(&tmp, &tm1); strftime(t1s, sizeof(t1s), "%H:%M", &tm1); }
 
     //Fixed the above city-local wallclock.
     //Why: local_ts = dt + tz_offset is already the epoch representing city-local wallclock expressed as a raw epoch. Using gmtime_r() on that epoch produces the city's wallclock fields; using localtime_r() applies the device/system timezone conversion and yields the wrong display.
@@ -178,147 +253,51 @@ bool calculateGraphDataFromForecastRaw(bool smooth) {
   }
   Serial.println("----- end debug -----");
 
+  // Resample every metric through its own instantiation (one call per metric)
+  for (int g = 0; g < NUM_GRAPHS; ++g) Graphs::resample[g](snap, map, s_series[g]);
 
-  // For each target hour H in 9..21, compute target_ts (local) for today's date
+  // mark an hour valid if at least one metric has a value
   bool anyValid = false;
   for (int i = 0; i < GRAPH_HOURS; ++i) {
-    int H = 9 + i;
-    long target_ts = midnight_local + (long)H * 3600L;
-
-    // find two samples s0,s1 such that s0.local_ts <= target_ts <= s1.local_ts
-    int idx0 = -1, idx1 = -1;
-    for (int s = 0; s < sampleCount; ++s) {
-      if (samples[s].local_ts <= target_ts) idx0 = s;
-      if (samples[s].local_ts >= target_ts) { idx1 = s; break; }
-    }
-
-    // if idx0 == -1 use first sample as both bounds (extrapolate/backfill)
-    if (idx0 == -1) idx0 = 0;
-    // if idx1 == -1 use last sample
-    if (idx1 == -1) idx1 = sampleCount - 1;
-
-    // if both indices are valid, compute interpolation weight
-    long t0 = samples[idx0].local_ts;
-    long t1 = samples[idx1].local_ts;
-
-    float tempVal = NAN;
-    float windVal = NAN;
-    float popVal  = NAN;
-
-    if (idx0 == idx1 || t1 == t0) {
-      // exact match or single sample
-      tempVal = samples[idx0].temp;
-      windVal = samples[idx0].wind;
-      popVal  = samples[idx0].pop;
-    } else {
-      double alpha = double(target_ts - t0) / double(t1 - t0);
-      // clamp alpha
-      if (alpha < 0.0) alpha = 0.0;
-      if (alpha > 1.0) alpha = 1.0;
-      // interpolate each value if not NaN; if NaN on one side, pick the other
-      float t0v = samples[idx0].temp;
-      float t1v = samples[idx1].temp;
-      if (!isnan(t0v) && !isnan(t1v)) tempVal = lerpFloat(t0v, t1v, alpha);
-      else if (!isnan(t0v)) tempVal = t0v;
-      else if (!isnan(t1v)) tempVal = t1v;
-
-      float w0v = samples[idx0].wind;
-      float w1v = samples[idx1].wind;
-      if (!isnan(w0v) && !isnan(w1v)) windVal = lerpFloat(w0v, w1v, alpha);
-      else if (!isnan(w0v)) windVal = w0v;
-      else if (!isnan(w1v)) windVal = w1v;
-
-      float p0v = samples[idx0].pop;
-      float p1v = samples[idx1].pop;
-      if (!isnan(p0v) && !isnan(p1v)) popVal = lerpFloat(p0v, p1v, alpha);
-      else if (!isnan(p0v)) popVal = p0v;
-      else if (!isnan(p1v)) popVal = p1v;
-    }
-
-    // mark valid if we have at least one non-NaN
-    bool valid = !(isnan(tempVal) && isnan(windVal) && isnan(popVal));
-    graphValid[i] = valid;
-    if (valid) {
-      graphTemp[i] = tempVal;
-      graphWind[i] = windVal;
-      graphPop[i]  = popVal;
-      anyValid = true;
-    } else {
-      graphTemp[i] = NAN;
-      graphWind[i] = NAN;
-      graphPop[i]  = NAN;
+    for (int g = 0; g < NUM_GRAPHS; ++g) {
+      if (!isnan(s_series[g][i])) { graphValid[i] = true; break; }
     }
+    if (graphValid[i]) anyValid = true;
   }
 
   //adding extra debugging here to see if data is valid
-  // --- DEBUG: print computed hourly arrays + stats ---
-Serial.println("DBG: Graph hourly arrays (raw / after interp):");
-float minT = 1e9, maxT = -1e9;
-float minW = 1e9, maxW = -1e9;
-int validCount = 0;
-for (int i = 0; i < GRAPH_HOURS; ++i) {
-  int H = graphHourLabels[i];
-  bool v = graphValid[i];
-
-  char tbuf[16], wbuf[16], pbuf[16];
-  if (v && !isnan(graphTemp[i])) snprintf(tbuf, sizeof(tbuf), "%.1f", graphTemp[i]); else snprintf(tbuf, sizeof(tbuf), "NaN");
-  if (v && !isnan(graphWind[i])) snprintf(wbuf, sizeof(wbuf), "%.1f", graphWind[i]); else snprintf(wbuf, sizeof(wbuf), "NaN");
-  if (v && !isnan(graphPop[i]))  snprintf(pbuf, sizeof(pbuf), "%.2f", graphPop[i]);  else snprintf(pbuf, sizeof(pbuf), "NaN");
-
-  Serial.printf(" H=%02d : T=%6s F  W=%6s mph  POP=%6s  valid=%d\n", H, tbuf, wbuf, pbuf, v ? 1 : 0);
-
-  if (v && !isnan(graphTemp[i])) { if (graphTemp[i] < minT) minT = graphTemp[i]; if (graphTemp[i] > maxT) maxT = graphTemp[i]; }
-  if (v && !isnan(graphWind[i])) { if (graphWind[i] < minW) minW = graphWind[i]; if (graphWind[i] > maxW) maxW = graphWind[i]; }
-  if (v) validCount++;
-}
-
-if (validCount == 0) {
-  Serial.println("DBG: No valid points!");
-} else {
-  Serial.printf("DBG: temp min=%.1f max=%.1f  wind min=%.1f max=%.1f  valid=%d\n",
-                (minT==1e9 ? NAN : minT),
-                (maxT==-1e9 ? NAN : maxT),
-                (minW==1e9 ? NAN : minW),
-                (maxW==-1e9 ? NAN : maxW),
-                validCount);
-}
-
+  // --- DEBUG: print computed hourly arrays ---
+  Serial.println("DBG: Graph hourly arrays (raw / after interp):");
+  for (int g = 0; g < NUM_GRAPHS; ++g) Graphs::print[g](s_series[g]);
+  if (!anyValid) Serial.println("DBG: No valid points!");
 
   // Optional smoothing (3-point moving average)
   if (smooth && anyValid) {
-    smoothArray(graphTemp, graphValid, GRAPH_HOURS);
-    smoothArray(graphWind, graphValid, GRAPH_HOURS);
-    smoothArray(graphPop, graphValid, GRAPH_HOURS);
+    for (int g = 0; g < NUM_GRAPHS; ++g) smoothArray(s_series[g], graphValid, GRAPH_HOURS);
   }
 
   // Debug print summary
   Serial.println("GraphUtils: calculateGraphDataFromForecastRaw() results:");
-  for (int i = 0; i < GRAPH_HOURS; ++i) {
-    int H = graphHourLabels[i];
-    if (graphValid[i]) {
-      char buf[120];
-      int popPct = isnan(graphPop[i]) ? -1 : int(round(graphPop[i] * 100.0f));
-      if (popPct >= 0)
-        snprintf(buf, sizeof(buf), " H=%02d : T=%.1fF  W=%.1fmph  POP=%d%%", H,
-                 isnan(graphTemp[i]) ? NAN : graphTemp[i],
-                 isnan(graphWind[i]) ? NAN : graphWind[i],
-                 popPct);
-      else
-        snprintf(buf, sizeof(buf), " H=%02d : T=%.1fF  W=%.1fmph  POP=N/A", H,
-                 isnan(graphTemp[i]) ? NAN : graphTemp[i],
-                 isnan(graphWind[i]) ? NAN : graphWind[i]);
-      Serial.println(buf);
-    } else {
-      Serial.printf(" H=%02d : no data\n", H);
-    }
+  for (int g = 0; g < NUM_GRAPHS; ++g) Graphs::print[g](s_series[g]);
+
+  // Value ranges for drawGraph()
+  for (int g = 0; g < NUM_GRAPHS; ++g) {
+    s_rangeValid[g] = findMinMax(s_series[g], graphValid, GRAPH_HOURS, s_rangeMin[g], s_rangeMax[g]);
   }
+  updatePointTables();
 
   return anyValid;
 }
 
+const float *graphSeries(int graphType) {
+  if (graphType < 0 || graphType >= NUM_GRAPHS) graphType = 0;
+  return s_series[graphType];
+}
+
 // -------------------------- setGraphArea --------------------------
 void setGraphArea(int x, int y, int w, int h) {
   g_x = x; g_y = y; g_w = w; g_h = h;
+  updatePointTables();
 }
 
 // -------------------------- helper: safe min/max -------------------
@@ -326,7 +305,7 @@ static bool findMinMax(const float *arr, const bool *valid, int n, float &minV,
   bool found = false;
   minV = 0; maxV = 0;
   for (int i = 0; i < n; ++i) {
-    if (!valid[i]) continue;
+    if (!valid[i] || isnan(arr[i])) continue;
     float v = arr[i];
     if (!found) { minV = maxV = v; found = true; }
     else {
@@ -339,91 +318,86 @@ static bool findMinMax(const float *arr, const bool *valid, int n, float &minV,
 
 // -------------------------- drawGraph ------------------------------
 void drawGraph(int graphType) {
-  // graphType: 0=temp, 1=wind, 2=pop
+  // graphType: index into GraphMetricList (0=temp, 1=wind, 2=pop, 3=humidity)
   if (g_w <= 8 || g_h <= 8) return; // area not set
 
   // Clear graph area
-  tft.fillRect(g_x, g_y, g_w, g_h, COL_BG);
+  screen.fillRect(g_x, g_y, g_w, g_h, COL_BG);
 
   // Draw border
-  tft.drawRect(g_x, g_y, g_w, g_h, COL_AXIS);
+  screen.drawRect(g_x, g_y, g_w, g_h, COL_AXIS);
 
-  // Choose metric arrays
-  float *arr = (graphType == 0) ? graphTemp : (graphType == 1) ? graphWind : graphPop;
-  const uint16_t lineColor = (graphType == 0) ? COL_TEMP : (graphType == 1) ? COL_WIND : COL_POP;
-  const char *title = (graphType == 0) ? "Temperature (F)" : (graphType == 1) ? "Wind (mph)" : "Precip %";
+  // Choose metric (one lookup; everything below is specialized per metric)
+  if (graphType < 0 || graphType >= NUM_GRAPHS) graphType = 0;
 
-  // Determine min/max for Y
-  float vmin, vmax;
-  bool hasData = findMinMax(arr, graphValid, GRAPH_HOURS, vmin, vmax);
-  if (!hasData) {
+  // Min/max for Y were found when the data was calculated
+  if (!s_rangeValid[graphType]) {
     // No data: render message
-    tft.setTextSize(1);
-    tft.setTextColor(COL_TEXT);
-    tft.setCursor(g_x + 6, g_y + g_h / 2 - 6);
-    tft.print("No graph data");
+    textDrawTransparent(g_x + 6, g_y + g_h / 2 - 6, "No graph data", 1, COL_TEXT);
     return;
   }
+  Graphs::draw[graphType](graphType);
+}
 
-  // For POP (0..1) convert to percent for nicer scale
-  bool showPercent = false;
-  if (graphType == 2) {
-    showPercent = true;
-    // values are 0..1; convert to 0..100 for plotting scale
-    for (int i = 0; i < GRAPH_HOURS; ++i) {
-      if (graphValid[i] && !isnan(graphPop[i])) graphPop[i] = graphPop[i] * 100.0f;
-    }
-    // re-evaluate min/max
-    findMinMax(arr, graphValid, GRAPH_HOURS, vmin, vmax);
-  }
+// Polyline pieces over a point row table (NO_POINT = gap)
+static void drawSegment(const int16_t *py, int i, uint16_t color) {
+  if (i < 0 || i >= GRAPH_HOURS - 1 || py[i] == NO_POINT || py[i + 1] == NO_POINT) return;
+  screen.drawLine(s_px[i], py[i], s_px[i + 1], py[i + 1], color);
+}
 
-  // Expand min/max a little for visual margin
-  float padding = (vmax - vmin) * 0.12f;
-  if (padding <= 0.5f) padding = 0.5f;
-  vmin -= padding;
-  vmax += padding;
-  if (vmin == vmax) { vmin -= 1.0f; vmax += 1.0f; }
+static void drawCap(const int16_t *py, int i, uint16_t color) {
+  if (i < 0 || i >= GRAPH_HOURS || py[i] == NO_POINT) return;
+  screen.fillCircle(s_px[i], py[i], CAP_R, color);
+}
+
+static int16_t gridY(int gi) {
+  return (int16_t)(g_y + (gi * (g_h - 1)) / GRAPH_GRID_LINES);
+}
+
+static int16_t hourTickX(int ti) {
+  return s_px[MAJOR_TICKS24[ti] - 9]; // hour index = hour - 9
+}
+
+static void drawHourTick(int ti) {
+  int hour24 = MAJOR_TICKS24[ti];
+  int xx = hourTickX(ti);
+  screen.drawFastVLine(xx, g_y + g_h - 12, 8, COL_AXIS);
+
+  // convert to 12-hour display and print without leading zero
+  int hour12 = hour24 % 12;
+  if (hour12 == 0) hour12 = 12;
+  char buf[6];
+  snprintf(buf, sizeof(buf), "%d", hour12);
+  textDrawTransparent(xx - 6, g_y + g_h - 10, buf, 1, COL_TEXT);
+}
+
+template <class M>
+static void drawMetric(int g) {
+  const uint16_t lineColor = M::color();
+  const float *arr = s_series[g];
+  const int16_t *py = s_py[g];
+
+  // Plot range (axis policy of the metric applied) comes with the point table
+  float vmin = s_plotMin[g], vmax = s_plotMax[g];
 
   // Draw horizontal grid lines (4 lines)
-  tft.setTextSize(1);
-  tft.setTextColor(COL_TEXT);
-  int gridLines = 4;
-  for (int gi = 0; gi <= gridLines; ++gi) {
-    int yy = g_y + (gi * (g_h - 1)) / gridLines;
+  for (int gi = 0; gi <= GRAPH_GRID_LINES; ++gi) {
+    int yy = gridY(gi);
     // faint grid
-    tft.drawFastHLine(g_x + 1, yy, g_w - 2, COL_GRID);
+    screen.drawFastHLine(g_x + 1, yy, g_w - 2, COL_GRID);
     // label Y at left
-    float vlabel = vmax - ( (float)gi * (vmax - vmin) / gridLines );
-    char lbl[12];
-    if (showPercent) snprintf(lbl, sizeof(lbl), "%d%%", (int)round(vlabel));
-    else snprintf(lbl, sizeof(lbl), "%g", round(vlabel*10)/10.0); // 1 decimal
-    tft.setCursor(g_x + 4, yy - 6);
-    tft.print(lbl);
+    float vlabel = vmax - ( (float)gi * (vmax - vmin) / GRAPH_GRID_LINES );
+    char lbl[LABEL_TICK_LEN];
+    M::Label::tick(lbl, sizeof(lbl), vlabel);
+    textDrawTransparent(g_x + 4, yy - 6, lbl, 1, COL_TEXT);
   }
 
     // Draw X ticks & hour labels (9,12,3,6,9 in 12-hour format)
-  tft.setTextSize(1);
-  const int majorTicks24[] = {9,12,15,18,21};
-  int numMajor = sizeof(majorTicks24)/sizeof(majorTicks24[0]);
-  for (int ti = 0; ti < numMajor; ++ti) {
-    int hour24 = majorTicks24[ti];
-    // map hour index to x position
-    float frac = float(hour24 - 9) / float(GRAPH_HOURS - 1);
-    int xx = g_x + 1 + (int)round(frac * (g_w - 3));
-    tft.drawFastVLine(xx, g_y + g_h - 12, 8, COL_AXIS);
-
-    // convert to 12-hour display and print without leading zero
-    int hour12 = hour24 % 12;
-    if (hour12 == 0) hour12 = 12;
-    char buf[6];
-    snprintf(buf, sizeof(buf), "%d", hour12);
-    tft.setCursor(xx - 6, g_y + g_h - 10);
-    tft.print(buf);
-  }
+  for (int ti = 0; ti < NUM_MAJOR_TICKS; ++ti) drawHourTick(ti);
 
 /*
   // Draw X ticks & hour labels (9,12,15,18,21)  //changed this out for the better code above using 12hr time frame. saving for delete later, or optional military time button later
-  tft.setTextSize(1);
+  screen.setTextSize(1);
   const int majorTicks[] = {9,12,15,18,21};
   int numMajor = sizeof(majorTicks)/sizeof(majorTicks[0]);
   for (int ti = 0; ti < numMajor; ++ti) {
@@ -431,65 +405,36 @@ void drawGraph(int graphType) {
     // map hour index to x: index = hour - 9
     float frac = float(hour - 9) / float(GRAPH_HOURS - 1);
     int xx = g_x + 1 + (int)round(frac * (g_w - 3));
-    tft.drawFastVLine(xx, g_y + g_h - 12, 8, COL_AXIS);
+    screen.drawFastVLine(xx, g_y + g_h - 12, 8, COL_AXIS);
     // small label under axis
     char buf[6];
     snprintf(buf, sizeof(buf), "%02d", hour);
-    tft.setCursor(xx - 6, g_y + g_h - 10);
-    tft.print(buf);
+    screen.setCursor(xx - 6, g_y + g_h - 10);
+    screen.print(buf);
   }
 */
 
 
 
-  // Compute pixel positions for each graph point
-  int px[GRAPH_HOURS], py[GRAPH_HOURS];
-  for (int i = 0; i < GRAPH_HOURS; ++i) {
-    float fracX = float(i) / float(GRAPH_HOURS - 1);
-    px[i] = g_x + 1 + (int)round(fracX * (g_w - 3)); // inside border
-    if (graphValid[i] && !isnan(arr[i])) {
-      float v = arr[i];
-      float fracY = (v - vmin) / (vmax - vmin);
-      if (fracY < 0) fracY = 0;
-      if (fracY > 1) fracY = 1;
-      py[i] = g_y + (g_h - 1) - (int)round(fracY * (g_h - 1));
-    } else {
-      py[i] = g_y + g_h - 1; // bottom as placeholder
-    }
-  }
+  // Draw polyline connecting consecutive valid points (pixel rows from the point table),
+  // a small cap on every point
+  for (int i = 0; i < GRAPH_HOURS - 1; ++i) drawSegment(py, i, lineColor);
+  for (int i = 0; i < GRAPH_HOURS; ++i) drawCap(py, i, lineColor);
 
-  // Draw polyline connecting consecutive valid points
-  for (int i = 0; i < GRAPH_HOURS - 1; ++i) {
-    if (graphValid[i] && graphValid[i+1]) {
-      tft.drawLine(px[i], py[i], px[i+1], py[i+1], lineColor);
-      // small cap
-      tft.fillCircle(px[i], py[i], 2, lineColor);
-    } else if (graphValid[i]) {
-      tft.fillCircle(px[i], py[i], 2, lineColor);
-    }
-  }
-  // last point dot
-  if (graphValid[GRAPH_HOURS-1]) tft.fillCircle(px[GRAPH_HOURS-1], py[GRAPH_HOURS-1], 2, lineColor);
+  // Observed vs forecast: recorded history for the same 9..21 window as hollow dots
+  drawObservedOverlay<M>(vmin, vmax);
 
-  // Draw title in top-left of graph area
-  tft.setTextSize(1);
-  tft.setTextColor(COL_TEXT);
-  tft.setCursor(g_x + 6, g_y + 4);
-  tft.print(title);
+  // Draw title in top-left of graph area (labels overlay the plot: transparent text runs)
+  textDrawTransparent(g_x + 6, g_y + 4, M::title(), 1, COL_TEXT);
 
   // Draw min/max labels top-right & bottom-right
-  char topLbl[16], botLbl[16];
-  if (showPercent) {
-    snprintf(topLbl, sizeof(topLbl), "Max %d%%", (int)round(vmax));
-    snprintf(botLbl, sizeof(botLbl), "Min %d%%", (int)round(vmin));
-  } else {
-    snprintf(topLbl, sizeof(topLbl), "Max %.0f", round(vmax));
-    snprintf(botLbl, sizeof(botLbl), "Min %.0f", round(vmin));
-  }
-  tft.setCursor(g_x + g_w - 60, g_y + 4);
-  tft.print(topLbl);
-  tft.setCursor(g_x + g_w - 60, g_y + g_h - 12);
-  tft.print(botLbl);
+  char topVal[12], botVal[12], topLbl[16], botLbl[16];
+  M::Label::whole(topVal, sizeof(topVal), vmax);
+  M::Label::whole(botVal, sizeof(botVal), vmin);
+  snprintf(topLbl, sizeof(topLbl), "Max %s", topVal);
+  snprintf(botLbl, sizeof(botLbl), "Min %s", botVal);
+  textDrawTransparent(g_x + g_w - 60, g_y + 4, topLbl, 1, COL_TEXT);
+  textDrawTransparent(g_x + g_w - 60, g_y + g_h - 12, botLbl, 1, COL_TEXT);
 
   // Draw current time marker: compute local fractional position
   struct tm timeinfo;
@@ -501,7 +446,7 @@ void drawGraph(int graphType) {
     if (fracPos >= 0.0f && fracPos <= 1.0f) {
       int markerX = g_x + 1 + (int)round(fracPos * (g_w - 3));
       // draw vertical guide
-      tft.drawFastVLine(markerX, g_y+2, g_h-4, COL_MARKER);
+      screen.drawFastVLine(markerX, g_y+2, g_h-4, COL_MARKER);
       // compute Y by interpolating between nearest graph points for selected metric
       // find surrounding indices
       float exactIdxF = curPos; // 0..12
@@ -522,7 +467,7 @@ void drawGraph(int graphType) {
         markerY = g_y + (g_h - 1) - (int)round(fracY * (g_h - 1));
       }
       // marker circle
-      tft.fillCircle(markerX, markerY, 4, COL_MARKER);
+      screen.fillCircle(markerX, markerY, 4, COL_MARKER);
 
       
             // label near marker -> show simple 12-hour "Hpm"/"Ham" (e.g. "3pm")
@@ -543,17 +488,198 @@ void drawGraph(int graphType) {
       // draw label with background for legibility
       int lblX = markerX + 6;
       int lblY = max(g_y + 6, markerY - 10);
-      tft.fillRect(lblX - 2, lblY - 2, 60, 12, COL_BG);
-      tft.setCursor(lblX, lblY);
-      tft.setTextSize(1);
-      tft.setTextColor(COL_MARKER);
-      tft.print(markerLabel);
+      screen.fillRect(lblX - 2, lblY - 2, 60, 12, COL_BG);
+      textDrawTransparent(lblX, lblY, markerLabel, 1, COL_MARKER);
     }
   }
 
   // done
 }
 
+// -------------------------- observed overlay --------------------------
+// Plots HistoryUtils samples recorded today between 9:00 and 21:00 (city-local),
+// using the same scale as the forecast line. No network or JSON access needed.
+template <class M>
+static void drawObservedOverlay(float vmin, float vmax) {
+  const WeatherSnapshot &snap = getWeatherSnapshot();
+  time_t now_t = time(NULL);
+  if (!snap.valid || now_t < 1600000000) return; // need NTP to place samples
+
+  time_t city_now = now_t + snap.tzOffset;
+  struct tm tm_city;
+  gmtime_r(&city_now, &tm_city);
+  time_t midnight_local = city_now - (tm_city.tm_hour * 3600 + tm_city.tm_min * 60 + tm_city.tm_sec);
+  uint32_t from = (uint32_t)(midnight_local - snap.tzOffset + 9L * 3600L);   // back to UTC
+  uint32_t to   = from + (uint32_t)(GRAPH_HOURS - 1) * 3600UL;
+
+  // 12 h at the default 10-minute refresh = 72 samples; a faster refresh is thinned so
+  // the circles still span the whole window
+  const int MAX_OBS = 96;
+  static HistorySample obs[MAX_OBS];
+  int n = queryHistory(from, to, obs, MAX_OBS, (to - from) / (MAX_OBS - 1));
+  for (int i = 0; i < n; ++i) {
+    float v = M::observed(obs[i]);
+    if (isnan(v)) continue;
+    float fracX = float(obs[i].ts - from) / float(to - from);
+    float fracY = (v - vmin) / (vmax - vmin);
+    if (fracY < 0) fracY = 0;
+    if (fracY > 1) fracY = 1;
+    int ox = g_x + 1 + (int)round(fracX * (g_w - 3));
+    int oy = g_y + (g_h - 1) - (int)round(fracY * (g_h - 1));
+    screen.drawCircle(ox, oy, 2, COL_OBSERVED);
+  }
+}
+
+// -------------------------- animated switch --------------------------
+// Band k spans the columns closest to point k (edges halfway to the neighbours; the
+// outer bands take in the border and the caps) and the plot rows plus the cap radius.
+// It is drawn from points k-1, k and k+1, so it is stale when any of those rows moved.
+static const int16_t BAND_STALE = INT16_MAX;   // never a plot row: forces a repaint
+
+static GraphAnimStats s_anim = {};
+static bool     s_animActive = false;
+static int      s_animFrom = 0, s_animTo = 0;
+static uint32_t s_animStart = 0;
+static uint32_t s_animLastFrame = 0;
+static bool     s_animSkipNext = false;
+static int      s_animNextBand = 0;            // where a frame cut by the budget resumes
+static int16_t  s_animY[GRAPH_HOURS];          // rows of this frame
+static int16_t  s_bandDrawn[GRAPH_HOURS][3];   // rows of points k-1, k, k+1 band k shows
+
+static int16_t bandX0(int k) {
+  return k == 0 ? (int16_t)(g_x - CAP_R) : (int16_t)((s_px[k - 1] + s_px[k] + 1) / 2);
+}
+
+static int16_t bandX1(int k) {
+  return k == GRAPH_HOURS - 1 ? (int16_t)(g_x + g_w + CAP_R) : bandX0(k + 1);
+}
+
+static int16_t animRow(int i) {
+  return (i < 0 || i >= GRAPH_HOURS) ? NO_POINT : s_animY[i];
+}
+
+static bool bandStale(int k) {
+  for (int j = 0; j < 3; ++j) {
+    if (s_bandDrawn[k][j] != animRow(k - 1 + j)) return true;
+  }
+  return false;
+}
+
+// Part [x0, x1) of a horizontal line starting at x, w pixels long
+static void bandHLine(int16_t x0, int16_t x1, int x, int y, int w, uint16_t color) {
+  int a = max((int)x0, x), b = min((int)x1, x + w);
+  if (a < b) screen.drawFastHLine(a, y, b - a, color);
+}
+
+// Clear band k and draw it again: border, grid and hour ticks, then the polyline
+// pieces that cross it. Title, range labels, overlay and marker wait for the final
+// full frame.
+static void repaintBand(int k, uint16_t color) {
+  int16_t x0 = bandX0(k), x1 = bandX1(k);
+  screen.fillRect(x0, g_y - CAP_R, x1 - x0, g_h + 2 * CAP_R, COL_BG);
+
+  bandHLine(x0, x1, g_x, g_y, g_w, COL_AXIS);
+  bandHLine(x0, x1, g_x, g_y + g_h - 1, g_w, COL_AXIS);
+  if (g_x >= x0 && g_x < x1) screen.drawFastVLine(g_x, g_y, g_h, COL_AXIS);
+  if (g_x + g_w - 1 >= x0 && g_x + g_w - 1 < x1) screen.drawFastVLine(g_x + g_w - 1, g_y, g_h, COL_AXIS);
+  for (int gi = 0; gi <= GRAPH_GRID_LINES; ++gi) bandHLine(x0, x1, g_x + 1, gridY(gi), g_w - 2, COL_GRID);
+  for (int ti = 0; ti < NUM_MAJOR_TICKS; ++ti) {
+    int xx = hourTickX(ti);
+    if (xx - 6 < x1 && xx + 6 > x0) drawHourTick(ti); // label reaches into the band
+  }
+
+  drawSegment(s_animY, k - 1, color);
+  drawSegment(s_animY, k, color);
+  drawCap(s_animY, k - 1, color);
+  drawCap(s_animY, k, color);
+  drawCap(s_animY, k + 1, color);
+
+  for (int j = 0; j < 3; ++j) s_bandDrawn[k][j] = animRow(k - 1 + j);
+}
+
+void graphBeginTransition(int fromType, int toType, uint32_t nowMs) {
+  if (toType < 0 || toType >= NUM_GRAPHS) toType = 0;
+#if GRAPH_ANIMATE
+  if (fromType >= 0 && fromType < NUM_GRAPHS && fromType != toType &&
+      g_w > 8 && g_h > 8 && s_rangeValid[fromType] && s_rangeValid[toType]) {
+    s_animActive = true;
+    s_animFrom = fromType;
+    s_animTo = toType;
+    s_animStart = nowMs;
+    s_animLastFrame = nowMs - GRAPH_ANIM_FRAME_MS;   // first frame is due at once
+    s_animSkipNext = false;
+    s_animNextBand = 0;
+    for (int k = 0; k < GRAPH_HOURS; ++k) {
+      for (int j = 0; j < 3; ++j) s_bandDrawn[k][j] = BAND_STALE;
+    }
+    s_anim.transitions++;
+    return;
+  }
+#endif
+  // Hard cut (animation off, or nothing to morph from/to)
+  s_animActive = false;
+  drawGraph(toType);
+}
+
+bool graphTransitionActive() {
+  return s_animActive;
+}
+
+bool graphTransitionFrame(uint32_t nowMs) {
+  if (!s_animActive) return false;
+  uint32_t since = nowMs - s_animLastFrame;
+  if (since < GRAPH_ANIM_FRAME_MS) return false;
+  s_anim.skipped += since / GRAPH_ANIM_FRAME_MS - 1;   // loop() came back late
+  s_animLastFrame = nowMs;
+  if (s_animSkipNext) {
+    // the previous frame overran: give the rest of loop() this slot
+    s_animSkipNext = false;
+    s_anim.skipped++;
+    return false;
+  }
+
+  uint32_t t0 = micros();
+  uint32_t elapsed = nowMs - s_animStart;
+  if (elapsed >= GRAPH_ANIM_MS) {
+    drawGraph(s_animTo);
+    s_animActive = false;
+  } else {
+    float t = (float)elapsed / (float)GRAPH_ANIM_MS;
+    float e = t * t * (3.0f - 2.0f * t);               // smoothstep: ease in and out
+    const int16_t *a = s_py[s_animFrom], *b = s_py[s_animTo];
+    for (int i = 0; i < GRAPH_HOURS; ++i) {
+      if (a[i] == NO_POINT)      s_animY[i] = b[i];    // only one side has the point
+      else if (b[i] == NO_POINT) s_animY[i] = a[i];
+      else s_animY[i] = (int16_t)(a[i] + (int)round((b[i] - a[i]) * e));
+    }
+
+    const uint16_t color = Graphs::color[s_animTo]();
+    int start = s_animNextBand;
+    s_animNextBand = 0;
+    for (int n = 0; n < GRAPH_HOURS; ++n) {
+      int k = (start + n) % GRAPH_HOURS;
+      if (!bandStale(k)) continue;
+      repaintBand(k, color);
+      s_anim.bands++;
+      if (micros() - t0 > GRAPH_ANIM_BUDGET_US) {
+        s_anim.overBudget++;
+        s_animSkipNext = true;
+        s_animNextBand = (k + 1) % GRAPH_HOURS;
+        break;
+      }
+    }
+  }
+
+  s_anim.frames++;
+  s_anim.lastUs = micros() - t0;
+  if (s_anim.lastUs > s_anim.maxUs) s_anim.maxUs = s_anim.lastUs;
+  return true;
+}
+
+const GraphAnimStats &getGraphAnimStats() {
+  return s_anim;
+}
+
 // ------------- helpers -------------
 static float lerpFloat(float a, float b, double t) {
   return a + (b - a) * (float)t;
@@ -2,21 +2,55 @@
 #define GRAPH_UTILS_H
 
 #include <Arduino.h>
+#include "GraphMetrics.h" // metric traits (GraphMetricList)
 
 const int GRAPH_HOURS = 13; // 9..21 inclusive
+const int NUM_GRAPHS = GraphMetricList::count;
 
 // Exported arrays (filled by calculateGraphDataFromForecastRaw)
-extern float graphTemp[GRAPH_HOURS];   // °F
-extern float graphWind[GRAPH_HOURS];   // mph
-extern float graphPop[GRAPH_HOURS];    // precipitation probability (0..1)
-extern bool  graphValid[GRAPH_HOURS];  // true if a value is present for that hour
+extern bool  graphValid[GRAPH_HOURS];  // true if any metric has a value for that hour
 extern int   graphHourLabels[GRAPH_HOURS]; // 9..21
 
-// Fills arrays from WeatherUtils cached forecast JSON
+// Fills the per-metric series from the WeatherUtils forecast snapshot (no JSON parsing)
 bool calculateGraphDataFromForecastRaw(bool smooth = true);
 
+// Hourly series of one metric in plot units (°F, mph, percent; NAN = no value)
+const float *graphSeries(int graphType);
+
 // Graph rendering API
 void setGraphArea(int x, int y, int w, int h);
-void drawGraph(int graphType); // 0 = temp, 1 = wind, 2 = pop (optional)
+void drawGraph(int graphType); // index into GraphMetricList (0 = temp, 1 = wind, ...)
+
+// ----- animated switch between graph types -----
+// The polyline morphs from one metric's point table to the other's (each on its own
+// axis), then the target graph is drawn in full (labels, overlay, marker). Point rows
+// are precomputed per metric with the data, so a frame only interpolates 13 rows.
+// The plot is split into one column band per point; a frame repaints only the bands
+// whose polyline changed since they were last drawn. A frame stops once it has used
+// GRAPH_ANIM_BUDGET_US (the remaining bands follow in the next frame) and the frame
+// after an overrun is skipped; the morph is timed, so it still ends on schedule.
+// GRAPH_ANIMATE 0 keeps the hard cut.
+#ifndef GRAPH_ANIMATE
+#define GRAPH_ANIMATE 1
+#endif
+const uint32_t GRAPH_ANIM_MS        = 500;    // morph duration
+const uint32_t GRAPH_ANIM_FRAME_MS  = 33;     // ~30 fps
+const uint32_t GRAPH_ANIM_BUDGET_US = 6000;   // render time per frame
+
+void graphBeginTransition(int fromType, int toType, uint32_t nowMs);
+bool graphTransitionActive();
+// Call on every loop() pass while active: draws when a frame is due, true if it drew
+bool graphTransitionFrame(uint32_t nowMs);
+
+struct GraphAnimStats {
+  uint32_t transitions;
+  uint32_t frames;          // frames drawn (incl. the final full graph)
+  uint32_t skipped;         // frames dropped: loop late, or after an overrun
+  uint32_t overBudget;      // frames cut short by the budget
+  uint32_t bands;           // column bands repainted
+  uint32_t lastUs;          // last frame's render time
+  uint32_t maxUs;
+};
+const GraphAnimStats &getGraphAnimStats();
 
 #endif // GRAPH_UTILS_H
@@ -0,0 +1,346 @@
+#include "HistoryUtils.h"
+#include "WeatherUtils.h"
+#include <Arduino.h>
+#include <math.h>
+#include <time.h>
+#if HISTORY_FLASH_MIRROR
+#include <Preferences.h>
+#endif
+
+// Ring of fixed-size blocks. Each block starts from a zero state, so a block can be
+// decoded (or dropped) on its own.
+static const int    HIST_BLOCKS      = 24;
+static const size_t HIST_BLOCK_BYTES = 256;
+static const int    HIST_FIELDS      = 4;
+static const int    HIST_MIRROR_EVERY = 6;   // mirror the open block every N samples (~1 h)
+static const int    HIST_MAX_SAMPLE_BYTES = 5 + 1 + HIST_FIELDS * 3;
+
+struct BlockInfo {
+  uint32_t firstMin;          // epoch minutes of first sample
+  uint32_t lastMin;           // epoch minutes of last sample
+  uint16_t used;              // bytes used in data
+  uint16_t count;             // samples in block
+  uint8_t  seen;              // bitmask of fields present in at least one sample
+  int16_t  minQ[HIST_FIELDS]; // quantized per-field min/max (valid if bit in 'seen')
+  int16_t  maxQ[HIST_FIELDS];
+};
+
+static uint8_t   s_data[HIST_BLOCKS][HIST_BLOCK_BYTES];
+static BlockInfo s_info[HIST_BLOCKS];
+static int       s_head = 0;        // block currently being written
+static int       s_blockCount = 0;  // blocks in use (0..HIST_BLOCKS)
+
+// Encoder state for the head block
+static int16_t s_prevQ[HIST_FIELDS];
+static uint8_t s_prevMask = 0;
+static int     s_sinceMirror = 0;
+
+// -------------------------- quantization --------------------------
+// temp/wind in tenths, humidity and pop in whole percent
+static uint8_t quantize(const HistorySample &s, int16_t q[HIST_FIELDS]) {
+  uint8_t mask = 0;
+  if (!isnan(s.temp))  { q[HIST_TEMP] = (int16_t)lroundf(s.temp * 10.0f); mask |= 1 << HIST_TEMP; }
+  if (!isnan(s.wind))  { q[HIST_WIND] = (int16_t)lroundf(s.wind * 10.0f); mask |= 1 << HIST_WIND; }
+  if (s.humidity >= 0) { q[HIST_HUMIDITY] = s.humidity;                    mask |= 1 << HIST_HUMIDITY; }
+  if (!isnan(s.pop))   { q[HIST_POP] = (int16_t)lroundf(s.pop * 100.0f);   mask |= 1 << HIST_POP; }
+  return mask;
+}
+
+static float dequantize(int field, int16_t q) {
+  switch (field) {
+    case HIST_TEMP:
+    case HIST_WIND: return q / 10.0f;
+    case HIST_POP:  return q / 100.0f;
+    default:        return (float)q;
+  }
+}
+
+// -------------------------- varint helpers --------------------------
+static size_t putVarint(uint8_t *out, uint32_t v) {
+  size_t n = 0;
+  while (v >= 0x80) { out[n++] = (uint8_t)(v | 0x80); v >>= 7; }
+  out[n++] = (uint8_t)v;
+  return n;
+}
+
+static bool getVarint(const uint8_t *buf, size_t len, size_t &pos, uint32_t &v) {
+  v = 0;
+  for (int shift = 0; shift < 35; shift += 7) {
+    if (pos >= len) return false;
+    uint8_t b = buf[pos++];
+    v |= (uint32_t)(b & 0x7F) << shift;
+    if (!(b & 0x80)) return true;
+  }
+  return false;
+}
+
+static uint32_t zigzag(int32_t v)   { return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31); }
+static int32_t  unzigzag(uint32_t v) { return (int32_t)(v >> 1) ^ -(int32_t)(v & 1); }
+
+// -------------------------- block decoding --------------------------
+// Walks one block, calling fn(sample, ctx) for each; stops early if fn returns false
+typedef bool (*SampleFn)(const HistorySample &s, void *ctx);
+
+static void decodeBlock(int b, SampleFn fn, void *ctx,
+                        int16_t *endQ = nullptr, uint8_t *endMask = nullptr) {
+  const BlockInfo &info = s_info[b];
+  int16_t q[HIST_FIELDS] = { 0, 0, 0, 0 };
+  uint8_t mask = 0x0F;
+  uint32_t minute = info.firstMin;
+  size_t pos = 0;
+
+  for (uint16_t n = 0; n < info.count; ++n) {
+    uint32_t head;
+    if (!getVarint(s_data[b], info.used, pos, head)) break;
+    minute += head >> 1;
+    if (head & 1) {
+      if (pos >= info.used) break;
+      mask = s_data[b][pos++];
+    }
+    for (int f = 0; f < HIST_FIELDS; ++f) {
+      if (!(mask & (1 << f))) continue;
+      uint32_t zz;
+      if (!getVarint(s_data[b], info.used, pos, zz)) return;
+      q[f] = (int16_t)(q[f] + unzigzag(zz));
+    }
+    if (fn) {
+      HistorySample s;
+      s.ts = minute * 60UL;
+      s.temp = (mask & (1 << HIST_TEMP)) ? dequantize(HIST_TEMP, q[HIST_TEMP]) : NAN;
+      s.wind = (mask & (1 << HIST_WIND)) ? dequantize(HIST_WIND, q[HIST_WIND]) : NAN;
+      s.pop  = (mask & (1 << HIST_POP))  ? dequantize(HIST_POP, q[HIST_POP])   : NAN;
+      s.humidity = (mask & (1 << HIST_HUMIDITY)) ? (int8_t)q[HIST_HUMIDITY] : -1;
+      if (!fn(s, ctx)) return;
+    }
+  }
+  if (endQ) memcpy(endQ, q, sizeof(q));
+  if (endMask) *endMask = mask;
+}
+
+static int oldestBlock() {
+  return (s_head - s_blockCount + 1 + HIST_BLOCKS) % HIST_BLOCKS;
+}
+
+// -------------------------- flash mirror --------------------------
+#if HISTORY_FLASH_MIRROR
+static void mirrorBlock(int b) {
+  Preferences prefs;
+  if (!prefs.begin("history", false)) return;
+  char key[8];
+  snprintf(key, sizeof(key), "i%02d", b);
+  prefs.putBytes(key, &s_info[b], sizeof(BlockInfo));
+  snprintf(key, sizeof(key), "b%02d", b);
+  prefs.putBytes(key, s_data[b], s_info[b].used);
+  prefs.putInt("head", s_head);
+  prefs.putInt("nblk", s_blockCount);
+  prefs.end();
+}
+
+static void loadFromFlash() {
+  Preferences prefs;
+  if (!prefs.begin("history", true)) return;
+  int head = prefs.getInt("head", -1);
+  int nblk = prefs.getInt("nblk", 0);
+  if (head < 0 || head >= HIST_BLOCKS || nblk <= 0 || nblk > HIST_BLOCKS) { prefs.end(); return; }
+  s_head = head;
+  s_blockCount = nblk;
+  for (int i = 0; i < nblk; ++i) {
+    int b = (head - i + HIST_BLOCKS) % HIST_BLOCKS;
+    char key[8];
+    snprintf(key, sizeof(key), "i%02d", b);
+    if (prefs.getBytes(key, &s_info[b], sizeof(BlockInfo)) != sizeof(BlockInfo) ||
+        s_info[b].used > HIST_BLOCK_BYTES) {
+      // stop at the first damaged block; keep the newer ones
+      s_blockCount = i;
+      break;
+    }
+    snprintf(key, sizeof(key), "b%02d", b);
+    prefs.getBytes(key, s_data[b], s_info[b].used);
+  }
+  prefs.end();
+}
+#endif
+
+// -------------------------- public API --------------------------
+void initHistory() {
+  memset(s_info, 0, sizeof(s_info));
+  s_head = 0;
+  s_blockCount = 0;
+  s_prevMask = 0x0F;
+  memset(s_prevQ, 0, sizeof(s_prevQ));
+#if HISTORY_FLASH_MIRROR
+  loadFromFlash();
+  if (s_blockCount > 0) {
+    // rebuild encoder state by replaying the open block
+    decodeBlock(s_head, nullptr, nullptr, s_prevQ, &s_prevMask);
+  }
+#endif
+  Serial.printf("HistoryUtils: %d samples in %d blocks (%u bytes)\n",
+                historySampleCount(), s_blockCount, (unsigned)historyBytesUsed());
+}
+
+// Encode s against the head block's state; returns byte count written to out
+static size_t encodeSample(const HistorySample &s, uint32_t minute, const BlockInfo &info,
+                           uint8_t *out, int16_t q[HIST_FIELDS], uint8_t &mask) {
+  memcpy(q, s_prevQ, sizeof(s_prevQ));
+  mask = quantize(s, q);
+  uint32_t delta = (info.count == 0) ? 0 : minute - info.lastMin;
+  bool maskChanged = (mask != s_prevMask);
+  size_t n = putVarint(out, (delta << 1) | (maskChanged ? 1 : 0));
+  if (maskChanged) out[n++] = mask;
+  for (int f = 0; f < HIST_FIELDS; ++f) {
+    if (mask & (1 << f)) n += putVarint(out + n, zigzag((int32_t)q[f] - s_prevQ[f]));
+  }
+  return n;
+}
+
+static void openNewBlock(uint32_t minute) {
+  if (s_blockCount > 0) {
+#if HISTORY_FLASH_MIRROR
+    mirrorBlock(s_head); // seal the finished block
+#endif
+    s_head = (s_head + 1) % HIST_BLOCKS;
+  }
+  if (s_blockCount < HIST_BLOCKS) s_blockCount++;
+  memset(&s_info[s_head], 0, sizeof(BlockInfo));
+  s_info[s_head].firstMin = minute;
+  memset(s_prevQ, 0, sizeof(s_prevQ));
+  s_prevMask = 0x0F;
+}
+
+bool recordObservation(const HistorySample &s) {
+  uint32_t minute = s.ts / 60UL;
+  if (minute == 0) return false;
+  if (s_blockCount > 0 && s_info[s_head].count > 0 && minute <= s_info[s_head].lastMin) return false;
+
+  if (s_blockCount == 0) openNewBlock(minute);
+
+  uint8_t buf[HIST_MAX_SAMPLE_BYTES];
+  int16_t q[HIST_FIELDS];
+  uint8_t mask;
+  size_t n = encodeSample(s, minute, s_info[s_head], buf, q, mask);
+  if (s_info[s_head].used + n > HIST_BLOCK_BYTES) {
+    openNewBlock(minute);
+    n = encodeSample(s, minute, s_info[s_head], buf, q, mask);
+  }
+
+  BlockInfo &info = s_info[s_head];
+  memcpy(s_data[s_head] + info.used, buf, n);
+  info.used += n;
+  info.count++;
+  info.lastMin = minute;
+  for (int f = 0; f < HIST_FIELDS; ++f) {
+    if (!(mask & (1 << f))) continue;
+    if (!(info.seen & (1 << f))) { info.minQ[f] = info.maxQ[f] = q[f]; info.seen |= 1 << f; }
+    else {
+      if (q[f] < info.minQ[f]) info.minQ[f] = q[f];
+      if (q[f] > info.maxQ[f]) info.maxQ[f] = q[f];
+    }
+  }
+  memcpy(s_prevQ, q, sizeof(s_prevQ));
+  s_prevMask = mask;
+
+#if HISTORY_FLASH_MIRROR
+  if (++s_sinceMirror >= HIST_MIRROR_EVERY) {
+    s_sinceMirror = 0;
+    mirrorBlock(s_head);
+  }
+#endif
+  return true;
+}
+
+bool recordHistoryFromSnapshot() {
+  const WeatherSnapshot &snap = getWeatherSnapshot();
+  if (!snap.valid) return false;
+  const ForecastSlot &now = snap.slots[0];
+  HistorySample s;
+  s.ts = snap.fetchedAt ? snap.fetchedAt : now.dt;
+  s.temp = now.temp;
+  s.wind = now.wind;
+  s.pop = now.pop;
+  s.humidity = now.humidity;
+  return recordObservation(s);
+}
+
+struct QueryCtx {
+  uint32_t from, to;
+  HistorySample *out;
+  int maxOut, n;
+  uint32_t spacing, next;   // keep a sample only once next is reached
+};
+
+static bool collectSample(const HistorySample &s, void *p) {
+  QueryCtx *c = (QueryCtx *)p;
+  if (s.ts > c->to) return false;
+  if (s.ts < c->from || s.ts < c->next) return true;
+  c->out[c->n++] = s;
+  c->next = s.ts + c->spacing;
+  return c->n < c->maxOut;
+}
+
+int queryHistory(uint32_t from, uint32_t to, HistorySample *out, int maxOut, uint32_t minSpacingSec) {
+  QueryCtx ctx = { from, to, out, maxOut, 0, minSpacingSec, from };
+  if (maxOut <= 0) return 0;
+  for (int i = 0, b = oldestBlock(); i < s_blockCount; ++i, b = (b + 1) % HIST_BLOCKS) {
+    const BlockInfo &info = s_info[b];
+    if (info.count == 0 || info.lastMin * 60UL < from) continue;
+    if (info.firstMin * 60UL > to) break;
+    decodeBlock(b, collectSample, &ctx);
+    if (ctx.n >= maxOut) break;
+  }
+  return ctx.n;
+}
+
+struct MinMaxCtx {
+  uint32_t from, to;
+  int field;
+  bool found;
+  float minV, maxV;
+};
+
+static void mergeMinMax(MinMaxCtx &c, float lo, float hi) {
+  if (!c.found) { c.minV = lo; c.maxV = hi; c.found = true; return; }
+  if (lo < c.minV) c.minV = lo;
+  if (hi > c.maxV) c.maxV = hi;
+}
+
+static bool minMaxSample(const HistorySample &s, void *p) {
+  MinMaxCtx *c = (MinMaxCtx *)p;
+  if (s.ts > c->to) return false;
+  if (s.ts < c->from) return true;
+  float v = (c->field == HIST_TEMP) ? s.temp : (c->field == HIST_WIND) ? s.wind :
+            (c->field == HIST_POP) ? s.pop : (s.humidity >= 0 ? (float)s.humidity : NAN);
+  if (!isnan(v)) mergeMinMax(*c, v, v);
+  return true;
+}
+
+bool historyMinMax(uint32_t from, uint32_t to, HistoryField field, float &minV, float &maxV) {
+  MinMaxCtx ctx = { from, to, (int)field, false, 0, 0 };
+  for (int i = 0, b = oldestBlock(); i < s_blockCount; ++i, b = (b + 1) % HIST_BLOCKS) {
+    const BlockInfo &info = s_info[b];
+    if (info.count == 0 || info.lastMin * 60UL < from) continue;
+    if (info.firstMin * 60UL > to) break;
+    if (info.firstMin * 60UL >= from && info.lastMin * 60UL <= to) {
+      // block fully inside the range: use its summary
+      if (info.seen & (1 << field))
+        mergeMinMax(ctx, dequantize(field, info.minQ[field]), dequantize(field, info.maxQ[field]));
+    } else {
+      decodeBlock(b, minMaxSample, &ctx);
+    }
+  }
+  minV = ctx.minV;
+  maxV = ctx.maxV;
+  return ctx.found;
+}
+
+int historySampleCount() {
+  int n = 0;
+  for (int i = 0, b = oldestBlock(); i < s_blockCount; ++i, b = (b + 1) % HIST_BLOCKS) n += s_info[b].count;
+  return n;
+}
+
+size_t historyBytesUsed() {
+  size_t n = 0;
+  for (int i = 0, b = oldestBlock(); i < s_blockCount; ++i, b = (b + 1) % HIST_BLOCKS) n += s_info[b].used;
+  return n;
+}
@@ -0,0 +1,53 @@
+#ifndef HISTORYUTILS_H
+#define HISTORYUTILS_H
+
+#include <Arduino.h>
+
+/*
+  HistoryUtils - rolling on-device history of observed conditions
+  - One observation (temp, wind, humidity, pop) is recorded per weather refresh,
+    taken from the current forecast slot (WeatherUtils snapshot slot 0).
+  - Samples are delta/varint encoded into fixed 256-byte blocks arranged as a ring;
+    when the ring is full the oldest block is dropped. ~6 KB holds a week+ at 10 min;
+    a faster refresh (the console allows 1 min) shortens the span in proportion.
+  - Each block keeps its time span and per-field min/max, so range queries skip
+    whole blocks and aggregates over fully covered blocks cost O(1) per block.
+  - With HISTORY_FLASH_MIRROR set, blocks are mirrored to NVS (Preferences) and
+    reloaded by initHistory() after a reboot.
+*/
+
+#ifndef HISTORY_FLASH_MIRROR
+#define HISTORY_FLASH_MIRROR 1
+#endif
+
+struct HistorySample {
+  uint32_t ts;       // UTC epoch seconds (minute resolution)
+  float    temp;     // °F (NAN if missing)
+  float    wind;     // mph (NAN if missing)
+  float    pop;      // 0..1 (NAN if missing)
+  int8_t   humidity; // % (-1 if missing)
+};
+
+enum HistoryField { HIST_TEMP = 0, HIST_WIND = 1, HIST_HUMIDITY = 2, HIST_POP = 3 };
+
+// Restore from flash (if mirrored) or start empty
+void initHistory();
+
+// Append one observation; ignored if ts is not newer than the last sample
+bool recordObservation(const HistorySample &s);
+
+// Record slot 0 of the current WeatherUtils snapshot (call after a successful fetch)
+bool recordHistoryFromSnapshot();
+
+// Copy samples with from <= ts <= to into out[] (oldest first). Returns number copied.
+// minSpacingSec > 0 skips samples closer than that to the last one copied, so a window
+// with more samples than out[] holds is thinned across its length instead of cut short.
+int queryHistory(uint32_t from, uint32_t to, HistorySample *out, int maxOut, uint32_t minSpacingSec = 0);
+
+// Min/max of one field over [from, to]. Returns false if no sample has that field.
+bool historyMinMax(uint32_t from, uint32_t to, HistoryField field, float &minV, float &maxV);
+
+int historySampleCount();
+size_t historyBytesUsed();
+
+#endif // HISTORYUTILS_H
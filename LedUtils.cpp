@@ -0,0 +1,233 @@
+#include "LedUtils.h"
+#include "WeatherUtils.h"
+#include <Arduino.h>
+#include <math.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include "Freenove_WS2812_Lib_for_ESP32.h"
+
+// extern strip declared in main sketch
+extern Freenove_ESP32_WS2812 strip;
+#endif
+
+// Lookup tables (built once, rebuilt on brightness change)
+static uint8_t s_lut[256];    // gamma 2.2 * brightness
+static uint8_t s_wave[256];   // (1 - cos) / 2 over one period, 0..255
+static bool    s_tablesReady = false;
+static uint8_t s_brightness = 64;
+
+static void buildTables() {
+  for (int i = 0; i < 256; ++i) {
+    float g = powf(i / 255.0f, 2.2f);
+    s_lut[i] = (uint8_t)lroundf(g * s_brightness);
+    s_wave[i] = (uint8_t)lroundf((1.0f - cosf(i * 2.0f * (float)M_PI / 256.0f)) * 127.5f);
+  }
+  s_tablesReady = true;
+}
+
+void ledSetBrightness(uint8_t brightness) {
+  s_brightness = brightness;
+  buildTables();
+}
+
+// -------------------------- scene selection --------------------------
+LedScene ledSceneFromConditions(float tempF, float windMph, float pop) {
+  LedScene s = {};
+  // base color from temperature band
+  if (isnan(tempF))     { s.r = 80;  s.g = 80;  s.b = 80; }
+  else if (tempF < 32)  { s.r = 180; s.g = 220; s.b = 255; } // freezing: icy white-blue
+  else if (tempF < 50)  { s.r = 0;   s.g = 160; s.b = 200; } // cold: teal
+  else if (tempF < 70)  { s.r = 40;  s.g = 200; s.b = 60; }  // mild: green
+  else if (tempF < 85)  { s.r = 255; s.g = 150; s.b = 0; }   // warm: amber
+  else                  { s.r = 255; s.g = 40;  s.b = 0; }   // hot: red
+  s.r2 = 0; s.g2 = 60; s.b2 = 255;
+
+  if (!isnan(pop) && pop >= 0.3f) {
+    // rain likely: pulses get deeper and faster with probability
+    s.effect = LED_EFFECT_RAIN;
+    s.depth = (uint8_t)(120 + (pop - 0.3f) / 0.7f * 135.0f);
+    s.periodMs = (uint16_t)(2560 - pop * 1280);
+  } else if (!isnan(windMph) && windMph >= 15.0f) {
+    s.effect = LED_EFFECT_GUST;
+    s.depth = (uint8_t)min(255.0f, windMph * 8.0f);
+    s.periodMs = 1600;
+  } else {
+    s.effect = LED_EFFECT_BREATHE;
+    s.depth = 90;
+    s.periodMs = 2560;
+  }
+  return s;
+}
+
+bool ledSceneEquals(const LedScene &a, const LedScene &b) {
+  return a.effect == b.effect && a.r == b.r && a.g == b.g && a.b == b.b &&
+         a.r2 == b.r2 && a.g2 == b.g2 && a.b2 == b.b2 &&
+         a.periodMs == b.periodMs && a.depth == b.depth;
+}
+
+// -------------------------- frame generator --------------------------
+// Cheap deterministic noise so a precomputed period repeats seamlessly
+static uint8_t hash8(uint32_t x) {
+  x ^= x >> 16; x *= 0x7feb352dU; x ^= x >> 15; x *= 0x846ca68bU; x ^= x >> 16;
+  return (uint8_t)x;
+}
+
+static uint8_t scale8(uint8_t v, uint8_t s) { return (uint8_t)(((uint16_t)v * s + 255) >> 8); }
+
+void ledGenerateFrame(const LedScene &scene, int frame, int frames, int ledCount, uint8_t *rgb) {
+  if (!s_tablesReady) buildTables();
+  if (frames <= 0) frames = 1;
+  uint8_t phase = (uint8_t)((frame * 256) / frames);
+  uint8_t breathe = (uint8_t)(255 - scene.depth + scale8(scene.depth, s_wave[phase]));
+
+  for (int i = 0; i < ledCount; ++i) {
+    uint8_t r = 0, g = 0, b = 0;
+    switch (scene.effect) {
+      case LED_EFFECT_BREATHE:
+        r = scale8(scene.r, breathe); g = scale8(scene.g, breathe); b = scale8(scene.b, breathe);
+        break;
+      case LED_EFFECT_RAIN: {
+        // pulse travels along the strip: each LED is offset in phase
+        uint8_t w = scale8(s_wave[(uint8_t)(phase + (i * 256) / max(1, ledCount))], scene.depth);
+        r = scene.r + (((int)scene.r2 - scene.r) * w) / 255;
+        g = scene.g + (((int)scene.g2 - scene.g) * w) / 255;
+        b = scene.b + (((int)scene.b2 - scene.b) * w) / 255;
+        break;
+      }
+      case LED_EFFECT_GUST: {
+        uint8_t n = hash8((uint32_t)frame * 31u + i);
+        uint8_t level = scale8(breathe, 255 - scale8(n, scene.depth) / 2);
+        r = scale8(scene.r, level); g = scale8(scene.g, level); b = scale8(scene.b, level);
+        break;
+      }
+      case LED_EFFECT_FLASH: {
+        // first half of the period on, second half dimmed by depth
+        uint8_t level = (phase < 128) ? 255 : 255 - scene.depth;
+        r = scale8(scene.r, level); g = scale8(scene.g, level); b = scale8(scene.b, level);
+        break;
+      }
+      default:
+        break;
+    }
+    rgb[i * 3 + 0] = s_lut[r];
+    rgb[i * 3 + 1] = s_lut[g];
+    rgb[i * 3 + 2] = s_lut[b];
+  }
+}
+
+int ledBuildFrameTable(const LedScene &scene, int ledCount, uint8_t table[][LED_MAX_COUNT * 3]) {
+  if (ledCount > LED_MAX_COUNT) ledCount = LED_MAX_COUNT;
+  int frames = (scene.effect == LED_EFFECT_OFF) ? 1 : scene.periodMs / LED_TICK_MS;
+  if (frames < 1) frames = 1;
+  if (frames > LED_MAX_FRAMES) frames = LED_MAX_FRAMES;
+  for (int f = 0; f < frames; ++f) ledGenerateFrame(scene, f, frames, ledCount, table[f]);
+  return frames;
+}
+
+// -------------------------- playback --------------------------
+// Two tables: the task plays s_tables[s_active] while a new scene is built into the
+// other one; the swap is a single int store. The task acks a swap by storing the index
+// it latched in s_shown; until then it may still be reading the old table, so a second
+// scene change in the meantime is parked in s_pending and built by ledService().
+static uint8_t s_tables[2][LED_MAX_FRAMES][LED_MAX_COUNT * 3];
+static int s_frames[2] = { 0, 0 };
+static int s_active = 0;
+#if defined(ARDUINO_ARCH_ESP32)
+static int s_shown = 0;                // table the task has latched (nothing read yet)
+#endif
+static int s_ledCount = 0;
+static LedScene s_scene = {};
+static bool s_haveScene = false;
+static LedScene s_pending = {};        // newest scene waiting for the ack
+static bool s_havePending = false;
+static LedScene s_weatherScene = {};   // shown whenever no alert flashes
+static bool s_alertOn = false;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static void ledTask(void *arg) {
+  (void)arg;
+  TickType_t last = xTaskGetTickCount();
+  int frame = 0, shown = -1;
+  for (;;) {
+    int a = __atomic_load_n(&s_active, __ATOMIC_ACQUIRE);   // table and count are complete
+    int n = s_frames[a];
+    bool changed = (a != shown);
+    if (changed) {
+      frame = 0;
+      shown = a;
+      __atomic_store_n(&s_shown, a, __ATOMIC_RELEASE);   // the other table is free now
+    }
+    if (frame >= n) frame = 0;
+    // a single-frame table is static: push it once
+    if (n > 1 || (n == 1 && changed)) {
+      const uint8_t *px = s_tables[a][frame];
+      for (int i = 0; i < s_ledCount; ++i) strip.setLedColorData(i, px[i * 3], px[i * 3 + 1], px[i * 3 + 2]);
+      strip.show();
+      frame = (frame + 1) % n;
+    }
+    vTaskDelayUntil(&last, pdMS_TO_TICKS(LED_TICK_MS));
+  }
+}
+#endif
+
+// The back table may be rebuilt once the task has moved off it
+static bool ledSwapAcked() {
+#if defined(ARDUINO_ARCH_ESP32)
+  return __atomic_load_n(&s_shown, __ATOMIC_ACQUIRE) == s_active;
+#else
+  return true;   // no playback task
+#endif
+}
+
+static void ledSetScene(const LedScene &scene) {
+  if (!ledSwapAcked()) {
+    s_pending = scene;
+    s_havePending = true;
+    return;
+  }
+  s_havePending = false;
+  if (s_haveScene && ledSceneEquals(scene, s_scene)) return;
+  int back = 1 - s_active;
+  s_frames[back] = ledBuildFrameTable(scene, s_ledCount, s_tables[back]);
+  __atomic_store_n(&s_active, back, __ATOMIC_RELEASE);
+  s_scene = scene;
+  s_haveScene = true;
+  Serial.printf("LedUtils: scene effect=%d color=%d,%d,%d depth=%d period=%dms (%d frames)\n",
+                scene.effect, scene.r, scene.g, scene.b, scene.depth, scene.periodMs, s_frames[back]);
+}
+
+void initLedEngine(uint8_t ledCount, uint8_t brightness) {
+  s_ledCount = min((int)ledCount, LED_MAX_COUNT);
+  ledSetBrightness(brightness);
+#if defined(ARDUINO_ARCH_ESP32)
+  strip.setBrightness(255); // brightness is applied through s_lut
+  xTaskCreatePinnedToCore(ledTask, "leds", 2048, nullptr, 1, nullptr, 0);
+#endif
+  s_weatherScene = ledSceneFromConditions(NAN, NAN, NAN);
+  ledSetScene(s_weatherScene);
+}
+
+void ledService() {
+  if (s_havePending && ledSwapAcked()) ledSetScene(s_pending);
+}
+
+void ledUpdateFromSnapshot() {
+  const WeatherSnapshot &snap = getWeatherSnapshot();
+  if (!snap.valid) return;
+  const ForecastSlot &now = snap.slots[0];
+  s_weatherScene = ledSceneFromConditions(now.temp, now.wind, now.pop);
+  if (!s_alertOn) ledSetScene(s_weatherScene);
+}
+
+void ledSetAlert(bool on, uint8_t r, uint8_t g, uint8_t b) {
+  s_alertOn = on;
+  if (!on) {
+    ledSetScene(s_weatherScene);
+    return;
+  }
+  LedScene s = {};
+  s.effect = LED_EFFECT_FLASH;
+  s.r = r; s.g = g; s.b = b;
+  s.periodMs = 1000;
+  s.depth = 255;
+  ledSetScene(s);
+}
@@ -0,0 +1,61 @@
+#ifndef LEDUTILS_H
+#define LEDUTILS_H
+
+#include <Arduino.h>
+
+/*
+  LedUtils - weather-driven animations for the WS2812 strip
+  - Conditions (temperature band, rain probability, wind) map to a LedScene.
+  - When the scene changes, one full animation period is precomputed into a frame
+    table (gamma + brightness applied through lookup tables).
+  - On the ESP32 a small FreeRTOS task on core 0 plays the table through the
+    Freenove driver (RMT), so the ticker/clock loop never waits on LED updates.
+  - A table is rebuilt only after the task has acked the previous swap; a scene that
+    changes again before that (a fetch and an alert in the same pass) waits for
+    ledService(), which also keeps only the newest one.
+  - ledSetAlert() replaces the scene with a flash while an alert (AlertUtils) is active.
+  - ledBuildFrameTable()/ledGenerateFrame() are plain C++ and can run on the host.
+*/
+
+const int LED_MAX_COUNT  = 8;    // LEDs supported per strip
+const int LED_MAX_FRAMES = 128;  // frames in one precomputed period
+const int LED_TICK_MS    = 20;   // 50 fps playback
+
+enum LedEffect : uint8_t {
+  LED_EFFECT_OFF = 0,
+  LED_EFFECT_BREATHE,   // slow breathing in the temperature color
+  LED_EFFECT_RAIN,      // blue pulses travelling along the strip
+  LED_EFFECT_GUST,      // breathing with wind flicker
+  LED_EFFECT_FLASH,     // alert: on/off blink in the base color
+};
+
+struct LedScene {
+  LedEffect effect;
+  uint8_t   r, g, b;       // base color (temperature band)
+  uint8_t   r2, g2, b2;    // accent color (rain)
+  uint16_t  periodMs;      // length of one animation period
+  uint8_t   depth;         // modulation depth 0..255
+};
+
+// Pick a scene for the given conditions (NAN-tolerant)
+LedScene ledSceneFromConditions(float tempF, float windMph, float pop);
+bool ledSceneEquals(const LedScene &a, const LedScene &b);
+
+// Brightness/gamma lookup used by the generator (0..255)
+void ledSetBrightness(uint8_t brightness);
+
+// Frame generator: writes ledCount RGB triplets for frame index 'frame' of 'frames'
+void ledGenerateFrame(const LedScene &scene, int frame, int frames, int ledCount, uint8_t *rgb);
+// Fills table[frame][led*3..] for a whole period; returns number of frames
+int ledBuildFrameTable(const LedScene &scene, int ledCount, uint8_t table[][LED_MAX_COUNT * 3]);
+
+// Device side: start the playback task and feed it new conditions
+void initLedEngine(uint8_t ledCount, uint8_t brightness);
+void ledUpdateFromSnapshot();     // uses WeatherUtils snapshot slot 0
+// Call on every loop() pass: builds a scene change that waited for the task's ack
+void ledService();
+// Alert override: flash in the given color until cleared; the weather scene keeps
+// following ledUpdateFromSnapshot() underneath and returns when the alert ends
+void ledSetAlert(bool on, uint8_t r = 0, uint8_t g = 0, uint8_t b = 0);
+
+#endif // LEDUTILS_H
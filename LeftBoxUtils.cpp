@@ -1,12 +1,12 @@
 #include "LeftBoxUtils.h"
 #include "WeatherUtils.h"
-#include <ArduinoJson.h>
+#include "TextUtils.h"
 #include <Adafruit_GFX.h>
 #include <Adafruit_ST7789.h>
 #include <Arduino.h>
 
 // extern TFT declared in main sketch
-extern Adafruit_ST7789 tft;
+#include "DisplayUtils.h"  // extern DisplaySurface &screen
 
 // Local cached strings (simple module-level state)
 static String lb_title[3] = { "Now Temp", "Wind", "Humidity" };
@@ -24,32 +24,18 @@ void calculateLeftBoxDataFromForecastRaw() {
   // Reset defaults
   for (int i = 0; i < 3; ++i) lb_value[i] = "N/A";
 
-  String raw = getCachedForecastRaw();
-  if (raw.length() < 10) {
-    // no cached forecast
-    Serial.println("LeftBoxUtils: no cached forecast available");
+  const WeatherSnapshot &snap = getWeatherSnapshot();
+  if (!snap.valid) {
+    // no forecast yet
+    Serial.println("LeftBoxUtils: no forecast snapshot available");
     return;
   }
 
-  // parse small JSON
-  StaticJsonDocument<4096> doc;
-  DeserializationError err = deserializeJson(doc, raw);
-  if (err) {
-    Serial.print("LeftBoxUtils: JSON parse error: ");
-    Serial.println(err.c_str());
-    return;
-  }
-
-  // Use first list[] item as 'now-ish' (3-hour window) — fallback safe reads
-  JsonObject first = doc["list"][0].as<JsonObject>();
-  if (!first) {
-    Serial.println("LeftBoxUtils: no list[0] in forecast");
-    return;
-  }
-
-  float temp = first["main"]["temp"] | NAN;
-  float wind = first["wind"]["speed"] | NAN;
-  int humidity = first["main"]["humidity"] | -1;
+  // "Now" values were interpolated once at ingest (snap.derived)
+  const WeatherDerived &d = snap.derived;
+  float temp = d.nowTemp;
+  float wind = d.nowWind;
+  int humidity = d.nowHumidity;
 
   // fill cached strings
   if (!isnan(temp)) lb_value[0] = String((int)round(temp)) + "F";
@@ -72,30 +58,21 @@ void drawLeftBoxes(int x, int y, int w, int h) {
   int gap = 4;
   int boxH = (h - gap*2) / 3;
 
-  tft.setTextSize(1);
-  tft.setTextColor(ST77XX_WHITE);
-
   for (int i = 0; i < 3; ++i) {
     int bx = x;
     int by = y + i * (boxH + gap);
     // background
-    tft.fillRect(bx, by, w, boxH, ST77XX_BLACK);
+    screen.fillRect(bx, by, w, boxH, ST77XX_BLACK);
     // border
-    tft.drawRect(bx, by, w, boxH, ST77XX_WHITE);
+    screen.drawRect(bx, by, w, boxH, ST77XX_WHITE);
 
-    // Title (small)
-    tft.setCursor(bx + 6, by + 4);
-    tft.print(lb_title[i]);
+    // Title (small); box interior is black, so glyphs go out as opaque cached cells
+    textDraw(bx + 6, by + 4, lb_title[i], 1, ST77XX_WHITE, ST77XX_BLACK);
 
     // Value (larger)
-    tft.setTextSize(2);
     // vertical center the value
     // nudge value down slightly to avoid collision with small title text above
     int vtextY = by + (boxH/2) - 2;
-    tft.setCursor(bx + 6, vtextY);
-    tft.print(lb_value[i]);
-
-    // restore small text size
-    tft.setTextSize(1);
+    textDraw(bx + 6, vtextY, lb_value[i], 2, ST77XX_WHITE, ST77XX_BLACK);
   }
 }
@@ -3,8 +3,8 @@
 
 #include <Arduino.h>
 
-// Calculate/refresh left-box data from the cached forecast JSON
-// (reads WeatherUtils::getCachedForecastRaw())
+// Calculate/refresh left-box data from the forecast snapshot
+// (reads WeatherUtils::getWeatherSnapshot())
 void calculateLeftBoxDataFromForecastRaw();
 
 // Draw the left boxes into the provided rectangle (x,y,w,h).
@@ -0,0 +1,217 @@
+#include "NetUtils.h"
+#include <WiFi.h>
+
+enum RadioState { RADIO_STATE_OFF, RADIO_STATE_SLEEP, RADIO_STATE_ACTIVE };
+
+static String s_ssid = "";
+static String s_password = "";
+static NetPowerMode s_mode = NET_POWER_ALWAYS_ON;
+static int s_holders = 0;                      // netAcquire() calls not yet released
+static RadioState s_state = RADIO_STATE_OFF;
+static uint32_t s_stateSince = 0;              // millis() of the last state change
+static NetStats s_stats = {};
+
+// Last association, reused so a reconnect from radio-off skips the channel scan
+static int32_t s_channel = 0;
+static uint8_t s_bssid[6];
+static bool s_haveBssid = false;
+
+// Background connect started by netAcquireNoWait(), advanced by netService()
+static bool s_connecting = false;
+static bool s_connectFast = false;             // current attempt targets the cached BSSID
+static uint32_t s_connectStart = 0;
+static const char* s_connectWho = "";
+
+static void (*s_wakeHooks[NET_MAX_WAKE_HOOKS])() = {};
+static int s_wakeHookCount = 0;
+
+static void addStateTime(NetStats &st, RadioState state, uint32_t ms) {
+  if (state == RADIO_STATE_ACTIVE) st.activeMs += ms;
+  else if (state == RADIO_STATE_SLEEP) st.sleepMs += ms;
+  else st.offMs += ms;
+}
+
+static void enterState(RadioState state) {
+  uint32_t now = millis();
+  addStateTime(s_stats, s_state, now - s_stateSince);
+  s_state = state;
+  s_stateSince = now;
+}
+
+static bool waitConnected(uint32_t start, unsigned long timeoutMs) {
+  while (WiFi.status() != WL_CONNECTED && (uint32_t)(millis() - start) < timeoutMs) delay(50);
+  return WiFi.status() == WL_CONNECTED;
+}
+
+// fast: straight to the last AP (cached channel/BSSID), otherwise a full scan
+static void beginConnect(bool fast) {
+  if (WiFi.getMode() != WIFI_STA) WiFi.mode(WIFI_STA);
+  WiFi.setSleep(false);
+  if (fast) WiFi.begin(s_ssid.c_str(), s_password.c_str(), s_channel, s_bssid);
+  else WiFi.begin(s_ssid.c_str(), s_password.c_str());
+}
+
+static void connectFailed(const char* who, uint32_t start) {
+  s_stats.failures++;
+  Serial.printf("NetUtils: %s: no Wi-Fi after %lu ms\n", who, (unsigned long)(millis() - start));
+}
+
+static void connectDone(const char* who, uint32_t start) {
+  uint32_t took = millis() - start;
+  s_stats.connects++;
+  s_stats.lastConnectMs = took;
+  if (took > s_stats.maxConnectMs) s_stats.maxConnectMs = took;
+  s_channel = WiFi.channel();
+  memcpy(s_bssid, WiFi.BSSID(), sizeof(s_bssid));
+  s_haveBssid = true;
+  Serial.printf("NetUtils: %s: connected in %lu ms, IP=%s\n", who, (unsigned long)took,
+                WiFi.localIP().toString().c_str());
+}
+
+// Blocking connect (netAcquire()); the fast path gets half the budget, then a full scan
+static bool connectNow(const char* who, unsigned long timeoutMs) {
+  uint32_t start = millis();
+  bool ok = false;
+  if (s_haveBssid) {
+    beginConnect(true);
+    ok = waitConnected(start, timeoutMs / 2);
+    if (!ok) s_haveBssid = false;
+  }
+  if (!ok) {
+    beginConnect(false);
+    ok = waitConnected(start, timeoutMs);
+  }
+  if (!ok) {
+    connectFailed(who, start);
+    return false;
+  }
+  connectDone(who, start);
+  return true;
+}
+
+// Puts the radio into the idle state of the current mode (nobody holds the link)
+static void goIdle() {
+  if (s_mode == NET_POWER_RADIO_OFF) {
+    WiFi.disconnect(true);
+    WiFi.mode(WIFI_OFF);
+    enterState(RADIO_STATE_OFF);
+  } else if (s_mode == NET_POWER_MODEM_SLEEP && WiFi.status() == WL_CONNECTED) {
+    WiFi.setSleep(WIFI_PS_MAX_MODEM);
+    enterState(RADIO_STATE_SLEEP);
+  } else if (s_mode == NET_POWER_MODEM_SLEEP) {
+    enterState(RADIO_STATE_SLEEP);   // auto-reconnect is pending; the next acquire waits for it
+  } else {
+    WiFi.setSleep(false);
+    enterState(RADIO_STATE_ACTIVE);
+  }
+}
+
+void initNet(const char* ssid, const char* password, NetPowerMode mode) {
+  s_ssid = String(ssid);
+  s_password = String(password);
+  s_mode = mode;
+  s_stateSince = millis();
+  WiFi.persistent(false);                          // no flash write on every begin()
+  WiFi.setAutoReconnect(mode != NET_POWER_RADIO_OFF);
+  Serial.printf("NetUtils: power mode %d\n", (int)mode);
+}
+
+void setNetPowerMode(NetPowerMode mode) {
+  if (mode == s_mode) return;
+  s_mode = mode;
+  WiFi.setAutoReconnect(mode != NET_POWER_RADIO_OFF);
+  if (s_holders == 0 && !s_connecting) {
+    if (mode != NET_POWER_RADIO_OFF && WiFi.getMode() != WIFI_STA) return; // next acquire reconnects
+    goIdle();
+  }
+}
+
+NetPowerMode getNetPowerMode() {
+  return s_mode;
+}
+
+static void takeHold() {
+  s_stats.acquires++;
+  if (s_holders++ == 0) {
+    enterState(RADIO_STATE_ACTIVE);
+    if (WiFi.status() == WL_CONNECTED) WiFi.setSleep(false);
+  }
+}
+
+static void runWakeHooks() {
+  if (s_holders != 1) return;
+  for (int i = 0; i < s_wakeHookCount; ++i) s_wakeHooks[i]();
+}
+
+bool netAcquire(const char* who, unsigned long timeoutMs) {
+  takeHold();
+  bool ok = WiFi.status() == WL_CONNECTED;
+  if (!ok) {
+    s_connecting = false; // a background attempt is taken over by this one
+    ok = connectNow(who, timeoutMs);
+  }
+  if (ok) runWakeHooks();
+  return ok;
+}
+
+bool netAcquireNoWait(const char* who) {
+  takeHold();
+  if (WiFi.status() == WL_CONNECTED) {
+    netService(); // a background attempt that just finished gets its stats
+    runWakeHooks();
+    return true;
+  }
+  if (!s_connecting) {
+    s_connecting = true;
+    s_connectFast = s_haveBssid;
+    s_connectStart = millis();
+    s_connectWho = who;
+    beginConnect(s_connectFast);
+  }
+  return false;
+}
+
+void netService() {
+  if (!s_connecting) return;
+  uint32_t elapsed = millis() - s_connectStart;
+  if (WiFi.status() == WL_CONNECTED) {
+    // the link stays up for the caller's retry; its netRelease() idles it
+    s_connecting = false;
+    connectDone(s_connectWho, s_connectStart);
+  } else if (s_connectFast && elapsed >= NET_CONNECT_TIMEOUT_MS / 2) {
+    s_connectFast = false;
+    s_haveBssid = false;
+    beginConnect(false);
+  } else if (elapsed >= NET_CONNECT_TIMEOUT_MS) {
+    s_connecting = false;
+    connectFailed(s_connectWho, s_connectStart);
+    if (s_holders == 0) goIdle();
+  }
+}
+
+bool netConnecting() {
+  return s_connecting;
+}
+
+void netRelease(const char* who) {
+  if (s_holders == 0) {
+    Serial.printf("NetUtils: %s: release without acquire\n", who);
+    return;
+  }
+  // a background connect keeps the radio up until it ends (netService())
+  if (--s_holders == 0 && !s_connecting) goIdle();
+}
+
+bool netConnected() {
+  return WiFi.status() == WL_CONNECTED;
+}
+
+void netOnWake(void (*cb)()) {
+  if (s_wakeHookCount < NET_MAX_WAKE_HOOKS) s_wakeHooks[s_wakeHookCount++] = cb;
+}
+
+NetStats getNetStats() {
+  NetStats st = s_stats;
+  addStateTime(st, s_state, millis() - s_stateSince);
+  return st;
+}
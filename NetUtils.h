@@ -0,0 +1,70 @@
+#ifndef NETUTILS_H
+#define NETUTILS_H
+
+#include <Arduino.h>
+
+/*
+  NetUtils - Wi-Fi connectivity manager shared by TimeUtils and WeatherUtils
+  - Modules bracket their network work with netAcquire(who) / netRelease(who). The
+    radio is brought to full power (and reconnected if needed) on the first acquire
+    and drops to the idle power state when the last holder releases it.
+  - Idle state per NetPowerMode:
+      NET_POWER_ALWAYS_ON   - associated, no power save (old behaviour)
+      NET_POWER_MODEM_SLEEP - associated, WIFI_PS_MAX_MODEM (radio wakes per DTIM);
+                              LAN services (status server, relay) stay reachable
+      NET_POWER_RADIO_OFF   - disconnected and WIFI_OFF; next acquire reconnects,
+                              reusing the cached channel/BSSID to skip the scan
+  - netAcquire() waits for the link (up to NET_CONNECT_TIMEOUT_MS) and is meant for
+    setup(). From loop(), netAcquireNoWait() only starts a background connect and
+    returns false; netService(), run every pass, advances it (cached BSSID, then a
+    full scan, then give up) and the caller tries again on a later pass.
+  - netOnWake(cb) hooks run right after an acquire brings the link up, so other
+    chores (NTP resync) ride along with the forecast fetch instead of waking the
+    radio on their own.
+  - getNetStats() reports reconnect latency and time spent in each radio state.
+*/
+
+enum NetPowerMode {
+  NET_POWER_ALWAYS_ON = 0,
+  NET_POWER_MODEM_SLEEP,
+  NET_POWER_RADIO_OFF,
+};
+
+const unsigned long NET_CONNECT_TIMEOUT_MS = 20UL * 1000UL;
+const int NET_MAX_WAKE_HOOKS = 4;
+
+// Stores the credentials; the first netAcquire() connects
+void initNet(const char* ssid, const char* password, NetPowerMode mode);
+void setNetPowerMode(NetPowerMode mode);   // applied immediately if nobody holds the link
+NetPowerMode getNetPowerMode();
+
+// Brings the link up (full power); true if connected. Every call must be paired with
+// netRelease(), also when it returns false.
+bool netAcquire(const char* who, unsigned long timeoutMs = NET_CONNECT_TIMEOUT_MS);
+// Same without waiting: false while the link is down, after starting a background
+// connect if none is running. Release it as well; retry while netConnecting().
+bool netAcquireNoWait(const char* who);
+void netRelease(const char* who);
+bool netConnected();
+bool netConnecting();        // a background connect is under way
+// Call on every loop() pass: advances a background connect
+void netService();
+
+// Called after netAcquire() has a working link (also when it was already up)
+void netOnWake(void (*cb)());
+
+struct NetStats {
+  uint32_t acquires;        // netAcquire() calls
+  uint32_t connects;        // acquires that had to (re)associate
+  uint32_t failures;        // acquires that timed out
+  uint32_t lastConnectMs;   // latency of the last (re)association
+  uint32_t maxConnectMs;
+  uint32_t activeMs;        // time at full power (link held)
+  uint32_t sleepMs;         // time associated in modem sleep
+  uint32_t offMs;           // time with the radio off
+};
+// Copy with the time in the current state included (loop side; StatusUtils gets a
+// copy through statusPublishSnapshot())
+NetStats getNetStats();
+
+#endif // NETUTILS_H
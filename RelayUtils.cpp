@@ -0,0 +1,337 @@
+#include "RelayUtils.h"
+#include <Arduino.h>
+#include <math.h>
+#include <errno.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include <lwip/sockets.h>
+#include <lwip/netdb.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#else
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <sys/select.h>
+#include <unistd.h>
+#include <mutex>
+#include <thread>
+#endif
+
+static_assert(sizeof(RelaySlot) == 10, "RelaySlot layout changed");
+static_assert(sizeof(RelayPacket) == 476, "RelayPacket layout changed");
+// Fields are packed and read in place: the wire format is little-endian, as the ESP32
+// and x86/ARM hosts are
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "RelayPacket needs a little-endian host");
+
+// Gateway state
+static RelayPacket s_outPkt;
+static bool        s_outValid = false;
+static volatile bool s_outDirty = false;
+
+// Subscriber state
+static WeatherSnapshot s_inSnap = {};
+static bool            s_inFresh = false;
+static uint32_t        s_inSeq = 0;
+static uint32_t        s_inFetchedAt = 0;
+static bool            s_inHeard = false;     // a valid packet arrived (any seq)
+static uint32_t        s_inHeardMs = 0;       // millis() of the last one
+
+#if defined(ARDUINO_ARCH_ESP32)
+static SemaphoreHandle_t s_lock = nullptr;
+static void lockState()   { if (s_lock) xSemaphoreTake(s_lock, portMAX_DELAY); }
+static void unlockState() { if (s_lock) xSemaphoreGive(s_lock); }
+static void startTask(void (*fn)(void *), const char *name) {
+  if (!s_lock) s_lock = xSemaphoreCreateMutex();
+  xTaskCreatePinnedToCore(fn, name, 3072, nullptr, 1, nullptr, 0);
+}
+#else
+static std::mutex s_lock;
+static void lockState()   { s_lock.lock(); }
+static void unlockState() { s_lock.unlock(); }
+static void startTask(void (*fn)(void *), const char *name) {
+  (void)name;
+  std::thread(fn, nullptr).detach();
+}
+#endif
+
+// -------------------------- packing --------------------------
+static uint32_t crc32(const uint8_t *p, size_t n) {
+  uint32_t crc = 0xFFFFFFFFu;
+  while (n--) {
+    crc ^= *p++;
+    for (int k = 0; k < 8; ++k) crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+  }
+  return ~crc;
+}
+
+void relayPack(const WeatherSnapshot &snap, RelayPacket &out) {
+  memset(&out, 0, sizeof(out));
+  out.magic = RELAY_MAGIC;
+  out.version = RELAY_VERSION;
+  out.size = sizeof(RelayPacket);
+  out.seq = snap.seq;
+  out.fetchedAt = snap.fetchedAt;
+  out.tzOffset = snap.tzOffset;
+  strlcpy(out.city, snap.city, sizeof(out.city));
+  strlcpy(out.desc, snap.desc, sizeof(out.desc));
+  out.count = snap.valid ? snap.count : 0;
+  for (int i = 0; i < out.count; ++i) {
+    const ForecastSlot &s = snap.slots[i];
+    RelaySlot &r = out.slots[i];
+    r.dt = s.dt;
+    r.temp10 = isnan(s.temp) ? INT16_MIN : (int16_t)lroundf(s.temp * 10.0f);
+    r.wind10 = isnan(s.wind) ? 0xFFFF : (uint16_t)lroundf(s.wind * 10.0f);
+    r.pop = isnan(s.pop) ? 0xFF : (uint8_t)lroundf(s.pop * 100.0f);
+    r.humidity = s.humidity;
+  }
+  out.crc32 = crc32((const uint8_t *)&out, offsetof(RelayPacket, crc32));
+}
+
+// Fixed-size text field of a packet: a valid CRC does not make it NUL-terminated, so never
+// scan past the field (strlcpy would strlen() the source)
+static void copyPacketText(char *dst, size_t dstSize, const char *src, size_t srcSize) {
+  size_t n = min(srcSize, dstSize - 1);
+  memcpy(dst, src, n);
+  dst[n] = '\0';
+}
+
+bool relayUnpack(const void *data, size_t len, WeatherSnapshot &out) {
+  if (len != sizeof(RelayPacket)) return false;
+  const RelayPacket &p = *(const RelayPacket *)data;
+  if (p.magic != RELAY_MAGIC || p.version != RELAY_VERSION || p.size != sizeof(RelayPacket)) return false;
+  if (p.count > SNAPSHOT_MAX_SLOTS) return false;
+  if (crc32((const uint8_t *)data, offsetof(RelayPacket, crc32)) != p.crc32) return false;
+
+  out.seq = p.seq;
+  out.fetchedAt = p.fetchedAt;
+  out.tzOffset = p.tzOffset;
+  copyPacketText(out.city, sizeof(out.city), p.city, sizeof(p.city));
+  copyPacketText(out.desc, sizeof(out.desc), p.desc, sizeof(p.desc));
+  out.count = p.count;
+  for (int i = 0; i < p.count; ++i) {
+    const RelaySlot &r = p.slots[i];
+    ForecastSlot &s = out.slots[i];
+    s.dt = r.dt;
+    s.temp = (r.temp10 == INT16_MIN) ? NAN : r.temp10 / 10.0f;
+    s.wind = (r.wind10 == 0xFFFF) ? NAN : r.wind10 / 10.0f;
+    s.pop = (r.pop == 0xFF) ? NAN : r.pop / 100.0f;
+    s.humidity = r.humidity;
+  }
+  out.valid = (p.count > 0);
+  return true;
+}
+
+// -------------------------- gateway --------------------------
+static void gatewayLoop(void *arg) {
+  (void)arg;
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) {
+    Serial.println("RelayUtils: gateway socket() failed");
+    return;
+  }
+  uint8_t ttl = 1; // stay on the local network
+  setsockopt(fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+  struct sockaddr_in dst;
+  memset(&dst, 0, sizeof(dst));
+  dst.sin_family = AF_INET;
+  dst.sin_port = htons(RELAY_PORT);
+  dst.sin_addr.s_addr = inet_addr(RELAY_GROUP);
+
+  static RelayPacket pkt;
+  unsigned long lastSend = 0;
+  for (;;) {
+    unsigned long now = millis();
+    if (s_outValid && (s_outDirty || now - lastSend >= RELAY_RESEND_MS)) {
+      lockState();
+      pkt = s_outPkt;
+      s_outDirty = false;
+      unlockState();
+      sendto(fd, &pkt, sizeof(pkt), 0, (struct sockaddr *)&dst, sizeof(dst));
+      lastSend = now;
+    }
+    delay(200);
+  }
+}
+
+bool initRelayGateway() {
+  startTask(gatewayLoop, "relay_tx");
+  Serial.printf("RelayUtils: gateway publishing to %s:%u every %lus\n",
+                RELAY_GROUP, RELAY_PORT, RELAY_RESEND_MS / 1000UL);
+  return true;
+}
+
+void relayPublish(const WeatherSnapshot &snap) {
+  lockState();
+  relayPack(snap, s_outPkt);
+  s_outValid = true;
+  s_outDirty = true;
+  unlockState();
+}
+
+// -------------------------- subscriber --------------------------
+// Accepts a decoded snapshot if it is newer than the last one handed out
+static void offerSnapshot(const WeatherSnapshot &snap) {
+  lockState();
+  s_inHeard = true;
+  s_inHeardMs = millis();
+  if (snap.seq != s_inSeq || snap.fetchedAt != s_inFetchedAt) {
+    s_inSnap = snap;
+    s_inSeq = snap.seq;
+    s_inFetchedAt = snap.fetchedAt;
+    s_inFresh = true;
+  }
+  unlockState();
+}
+
+static void subscriberLoop(void *arg) {
+  (void)arg;
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) {
+    Serial.println("RelayUtils: subscriber socket() failed");
+    return;
+  }
+  int yes = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(RELAY_PORT);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    Serial.println("RelayUtils: subscriber bind() failed");
+    close(fd);
+    return;
+  }
+  struct ip_mreq mreq;
+  mreq.imr_multiaddr.s_addr = inet_addr(RELAY_GROUP);
+  mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+  if (setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+    Serial.println("RelayUtils: could not join multicast group (HTTP fallback only)");
+  }
+
+  static RelayPacket pkt;
+  static WeatherSnapshot snap;
+  for (;;) {
+    int n = recv(fd, &pkt, sizeof(pkt), 0);
+    if (n <= 0) { delay(100); continue; }
+    if (relayUnpack(&pkt, (size_t)n, snap)) offerSnapshot(snap);
+  }
+}
+
+bool initRelaySubscriber() {
+  startTask(subscriberLoop, "relay_rx");
+  Serial.printf("RelayUtils: listening for snapshots on %s:%u\n", RELAY_GROUP, RELAY_PORT);
+  return true;
+}
+
+bool relayHasLatest() {
+  lockState();
+  bool fresh = s_inFresh;
+  unlockState();
+  return fresh;
+}
+
+bool relayTakeLatest(WeatherSnapshot &out) {
+  lockState();
+  bool fresh = s_inFresh;
+  if (fresh) {
+    out = s_inSnap;
+    s_inFresh = false;
+  }
+  unlockState();
+  return fresh;
+}
+
+// connect() with a deadline: SO_SNDTIMEO does not bound connect() on lwIP, and this runs
+// on the render loop, so a dead gateway must not hold it for the TCP connect timeout
+static bool connectWithin(int fd, const struct sockaddr *addr, socklen_t addrLen, uint32_t timeoutMs) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  if (flags < 0 || fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) return false;
+  bool ok = connect(fd, addr, addrLen) == 0;
+  if (!ok && errno == EINPROGRESS) {
+    fd_set wfds;
+    FD_ZERO(&wfds);
+    FD_SET(fd, &wfds);
+    struct timeval tv = { (long)(timeoutMs / 1000), (long)(timeoutMs % 1000) * 1000L };
+    if (select(fd + 1, nullptr, &wfds, nullptr, &tv) == 1) {
+      int err = 0;
+      socklen_t len = sizeof(err);
+      ok = getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &len) == 0 && err == 0;
+    }
+  }
+  fcntl(fd, F_SETFL, flags);   // back to blocking (reads are bounded by SO_RCVTIMEO)
+  return ok;
+}
+
+bool relayHeardWithin(uint32_t ms) {
+  lockState();
+  bool heard = s_inHeard && (uint32_t)(millis() - s_inHeardMs) < ms;
+  unlockState();
+  return heard;
+}
+
+bool relayFetchHttp(const char *host, uint16_t port, WeatherSnapshot &out) {
+  // a host name too long for the request buffer would send a truncated request
+  char req[96];
+  int reqLen = snprintf(req, sizeof(req), "GET /forecast.bin HTTP/1.0\r\nHost: %s\r\n\r\n", host);
+  if (reqLen < 0 || reqLen >= (int)sizeof(req)) {
+    Serial.println("RelayUtils: gateway host name too long");
+    return false;
+  }
+
+  // a dotted address skips the resolver (which has its own, longer timeout)
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) {
+    struct addrinfo hints, *res = nullptr;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, nullptr, &hints, &res) != 0 || !res) {
+      Serial.printf("RelayUtils: cannot resolve %s\n", host);
+      return false;
+    }
+    addr.sin_addr = ((struct sockaddr_in *)res->ai_addr)->sin_addr;
+    freeaddrinfo(res);
+  }
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0) {
+    Serial.println("RelayUtils: socket() failed");
+    return false;
+  }
+  struct timeval tv = { (long)(RELAY_HTTP_TIMEOUT_MS / 1000), (long)(RELAY_HTTP_TIMEOUT_MS % 1000) * 1000L };
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+  if (!connectWithin(fd, (struct sockaddr *)&addr, sizeof(addr), RELAY_HTTP_TIMEOUT_MS)) {
+    close(fd);
+    Serial.printf("RelayUtils: cannot connect to %s:%u\n", host, port);
+    return false;
+  }
+
+  send(fd, req, reqLen, 0);
+
+  // header + body fit comfortably in one buffer; read until the server closes
+  static uint8_t buf[sizeof(RelayPacket) + 512];
+  size_t n = 0;
+  for (;;) {
+    int r = recv(fd, buf + n, sizeof(buf) - n, 0);
+    if (r <= 0) break;
+    n += (size_t)r;
+    if (n == sizeof(buf)) break;
+  }
+  close(fd);
+
+  const uint8_t *body = nullptr;
+  for (size_t i = 0; i + 4 <= n; ++i) {
+    if (memcmp(buf + i, "\r\n\r\n", 4) == 0) { body = buf + i + 4; break; }
+  }
+  // status line: "HTTP/1.x 200 ..."
+  if (!body || strncmp((const char *)buf, "HTTP/1.", 7) != 0 || memcmp(buf + 8, " 200", 4) != 0) return false;
+  return relayUnpack(body, n - (body - buf), out);
+}
@@ -0,0 +1,78 @@
+#ifndef RELAYUTILS_H
+#define RELAYUTILS_H
+
+#include <Arduino.h>
+#include "WeatherUtils.h"
+
+/*
+  RelayUtils - compact binary forecast relay (one gateway feeds many stations)
+  - A gateway station fetches OpenWeather as usual, packs the snapshot into a
+    fixed-layout RelayPacket (~480 bytes) and multicasts it on the LAN after each
+    fetch and every RELAY_RESEND_MS. The same packet is served over HTTP as
+    /forecast.bin by StatusUtils.
+  - Subscriber stations listen on the multicast group (or GET /forecast.bin from
+    the gateway) and load the packet into a WeatherSnapshot: a CRC check and a
+    field copy, no JSON.
+  - Plain BSD sockets, so gateway and subscriber also run on the host over loopback.
+*/
+
+#define RELAY_GROUP "239.255.42.99"
+const uint16_t      RELAY_PORT      = 42099;
+const unsigned long RELAY_RESEND_MS = 30UL * 1000UL;
+const uint32_t      RELAY_HTTP_TIMEOUT_MS = 1000; // fallback connect / each read (runs on loop())
+
+const uint32_t RELAY_MAGIC   = 0x31525357; // "WSR1"
+const uint16_t RELAY_VERSION = 1;
+
+enum RelayRole {
+  RELAY_ROLE_DIRECT = 0,   // fetch from OpenWeather only (default)
+  RELAY_ROLE_GATEWAY,      // fetch from OpenWeather and publish to the LAN
+  RELAY_ROLE_SUBSCRIBER,   // load snapshots from a gateway, no API key needed
+};
+
+// Wire format: little-endian, packed, fixed size
+struct __attribute__((packed)) RelaySlot {
+  uint32_t dt;        // UTC epoch seconds
+  int16_t  temp10;    // °F * 10 (INT16_MIN = missing)
+  uint16_t wind10;    // mph * 10 (0xFFFF = missing)
+  uint8_t  pop;       // percent (0xFF = missing)
+  int8_t   humidity;  // percent (-1 = missing)
+};
+
+struct __attribute__((packed)) RelayPacket {
+  uint32_t  magic;
+  uint16_t  version;
+  uint16_t  size;       // sizeof(RelayPacket)
+  uint32_t  seq;        // gateway snapshot sequence number
+  uint32_t  fetchedAt;
+  int32_t   tzOffset;
+  char      city[24];
+  char      desc[24];
+  uint8_t   count;
+  uint8_t   reserved[3];
+  RelaySlot slots[SNAPSHOT_MAX_SLOTS];
+  uint32_t  crc32;      // over every byte before this field
+};
+
+void relayPack(const WeatherSnapshot &snap, RelayPacket &out);
+bool relayUnpack(const void *data, size_t len, WeatherSnapshot &out);
+
+// Gateway: start the multicast sender and hand it each new snapshot
+bool initRelayGateway();
+void relayPublish(const WeatherSnapshot &snap);
+
+// Subscriber: start the multicast listener; relayTakeLatest() returns true once
+// per newly received snapshot
+bool initRelaySubscriber();
+bool relayTakeLatest(WeatherSnapshot &out);
+// True when relayTakeLatest() has a snapshot to hand out (does not take it)
+bool relayHasLatest();
+// True when a valid multicast packet (new or a resend) arrived in the last ms
+bool relayHeardWithin(uint32_t ms);
+
+// Subscriber fallback: GET /forecast.bin from a gateway. Blocks loop() for at most
+// RELAY_HTTP_TIMEOUT_MS per step (connect, each read); give the gateway as an IP address
+// so no name lookup is needed
+bool relayFetchHttp(const char *host, uint16_t port, WeatherSnapshot &out);
+
+#endif // RELAYUTILS_H
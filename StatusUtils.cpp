@@ -0,0 +1,348 @@
+#include "StatusUtils.h"
+#include "WeatherUtils.h"
+#include "RelayUtils.h"
+#include "NetUtils.h"
+#include "AlertUtils.h"
+#include "TickerUtils.h"
+#include "GraphUtils.h"
+#include <Arduino.h>
+#include <stdarg.h>
+#include <math.h>
+#if defined(ARDUINO_ARCH_ESP32)
+#include <lwip/sockets.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#else
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include <mutex>
+#include <thread>
+#endif
+
+// Copy of the state the server reports; written by loop(), read by the server task
+static WeatherSnapshot   s_pubSnap = {};
+static WeatherFetchStats s_pubFetch = {};
+static NetStats          s_pubNet = {};
+static AlertStats        s_pubAlerts = {};
+static TickerStats       s_pubTicker = {};
+static TickerMessageInfo s_pubTickerMsgs[TICKER_MAX_MSGS];
+static int               s_pubTickerCount = 0;
+static GraphAnimStats    s_pubGraphAnim = {};
+
+// Frame timing (single writer: loop(); 32-bit stores are atomic on the ESP32)
+static volatile uint32_t s_frames = 0;
+static volatile uint32_t s_frameLastUs = 0;
+static volatile uint32_t s_frameMaxUs = 0;
+static volatile uint32_t s_frameAvgUs = 0;   // exponential moving average (1/16)
+static volatile uint32_t s_requests = 0;
+
+static int s_listenFd = -1;
+
+#if defined(ARDUINO_ARCH_ESP32)
+static SemaphoreHandle_t s_lock = nullptr;
+static void lockState()   { if (s_lock) xSemaphoreTake(s_lock, portMAX_DELAY); }
+static void unlockState() { if (s_lock) xSemaphoreGive(s_lock); }
+#else
+static std::mutex s_lock;
+static void lockState()   { s_lock.lock(); }
+static void unlockState() { s_lock.unlock(); }
+#endif
+
+// -------------------------- publishing (loop side) --------------------------
+void statusPublishSnapshot() {
+  lockState();
+  s_pubSnap = getWeatherSnapshot();
+  s_pubFetch = getWeatherFetchStats();
+  s_pubNet = getNetStats();
+  s_pubAlerts = getAlertStats();
+  s_pubTicker = getTickerStats();
+  s_pubTickerCount = min(tickerMessages(s_pubTickerMsgs, TICKER_MAX_MSGS), (int)TICKER_MAX_MSGS);
+  s_pubGraphAnim = getGraphAnimStats();
+  unlockState();
+}
+
+void statusNoteFrame(uint32_t frameUs) {
+  s_frames = s_frames + 1;
+  s_frameLastUs = frameUs;
+  if (frameUs > s_frameMaxUs) s_frameMaxUs = frameUs;
+  s_frameAvgUs = (s_frameAvgUs == 0) ? frameUs : s_frameAvgUs - s_frameAvgUs / 16 + frameUs / 16;
+}
+
+LoopFrameStats getLoopFrameStats() {
+  LoopFrameStats fs;
+  fs.frames = s_frames;
+  fs.lastUs = s_frameLastUs;
+  fs.avgUs = s_frameAvgUs;
+  fs.maxUs = s_frameMaxUs;
+  return fs;
+}
+
+// -------------------------- response writer --------------------------
+// Formats straight into one TCP segment worth of buffer and sends whenever it fills
+struct SockWriter {
+  int    fd;
+  char   buf[1460];
+  size_t len;
+  bool   ok;
+};
+
+static void wFlush(SockWriter &w) {
+  size_t off = 0;
+  while (w.ok && off < w.len) {
+    int n = send(w.fd, w.buf + off, w.len - off, 0);
+    if (n <= 0) { w.ok = false; break; }
+    off += (size_t)n;
+  }
+  w.len = 0;
+}
+
+static void wWrite(SockWriter &w, const void *data, size_t n) {
+  const char *p = (const char *)data;
+  while (n > 0 && w.ok) {
+    size_t room = sizeof(w.buf) - w.len;
+    size_t chunk = n < room ? n : room;
+    memcpy(w.buf + w.len, p, chunk);
+    w.len += chunk; p += chunk; n -= chunk;
+    if (w.len == sizeof(w.buf)) wFlush(w);
+  }
+}
+
+static void wPrintf(SockWriter &w, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+static void wPrintf(SockWriter &w, const char *fmt, ...) {
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    size_t room = sizeof(w.buf) - w.len;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(w.buf + w.len, room, fmt, ap);
+    va_end(ap);
+    if (n < 0) return;
+    if ((size_t)n < room) { w.len += n; return; }
+    if (w.len == 0) { w.len = sizeof(w.buf) - 1; return; } // longer than a segment: truncate
+    wFlush(w); // retry into an empty buffer
+  }
+}
+
+// JSON string body with the few escapes a city/description can need
+static void wJsonString(SockWriter &w, const char *s) {
+  wWrite(w, "\"", 1);
+  for (; *s; ++s) {
+    char c = *s;
+    if (c == '"' || c == '\\') { wWrite(w, "\\", 1); wWrite(w, &c, 1); }
+    else if ((uint8_t)c >= 0x20) wWrite(w, &c, 1);
+  }
+  wWrite(w, "\"", 1);
+}
+
+static void wHeader(SockWriter &w, int code, const char *reason, const char *type) {
+  wPrintf(w, "HTTP/1.1 %d %s\r\nContent-Type: %s\r\nCache-Control: no-store\r\nConnection: close\r\n\r\n",
+          code, reason, type);
+}
+
+// -------------------------- endpoints --------------------------
+static void sendMetrics(SockWriter &w) {
+  lockState();
+  WeatherFetchStats fs = s_pubFetch;
+  NetStats ns = s_pubNet;
+  AlertStats as = s_pubAlerts;
+  TickerStats ts = s_pubTicker;
+  static TickerMessageInfo tm[TICKER_MAX_MSGS]; // server task only; kept off its 4 KB stack
+  int tmCount = s_pubTickerCount;
+  memcpy(tm, s_pubTickerMsgs, sizeof(tm));
+  GraphAnimStats ga = s_pubGraphAnim;
+  uint32_t fetchedAt = s_pubSnap.fetchedAt;
+  unlockState();
+
+  uint32_t nowMs = millis();
+  uint32_t freeHeap = 0, minHeap = 0, maxAlloc = 0, stackFree = 0;
+#if defined(ARDUINO_ARCH_ESP32)
+  freeHeap = ESP.getFreeHeap();
+  minHeap = ESP.getMinFreeHeap();
+  maxAlloc = ESP.getMaxAllocHeap();
+  stackFree = uxTaskGetStackHighWaterMark(nullptr); // bytes on the ESP32 port
+#endif
+  long snapshotAge = fs.haveSuccess ? (long)((nowMs - fs.lastSuccessMs) / 1000UL) : -1;
+
+  wHeader(w, 200, "OK", "text/plain; version=0.0.4");
+  wPrintf(w, "ws_uptime_seconds %lu\n", (unsigned long)(nowMs / 1000UL));
+  wPrintf(w, "ws_heap_free_bytes %lu\n", (unsigned long)freeHeap);
+  wPrintf(w, "ws_heap_min_free_bytes %lu\n", (unsigned long)minHeap);
+  wPrintf(w, "ws_heap_max_alloc_bytes %lu\n", (unsigned long)maxAlloc);
+  wPrintf(w, "ws_status_stack_min_free_bytes %lu\n", (unsigned long)stackFree);
+  wPrintf(w, "ws_fetch_attempts_total %lu\n", (unsigned long)fs.attempts);
+  wPrintf(w, "ws_fetch_failures_total %lu\n", (unsigned long)fs.failures);
+  wPrintf(w, "ws_fetch_latency_ms %lu\n", (unsigned long)fs.lastLatencyMs);
+  wPrintf(w, "ws_wifi_acquires_total %lu\n", (unsigned long)ns.acquires);
+  wPrintf(w, "ws_wifi_connects_total %lu\n", (unsigned long)ns.connects);
+  wPrintf(w, "ws_wifi_connect_failures_total %lu\n", (unsigned long)ns.failures);
+  wPrintf(w, "ws_wifi_connect_last_ms %lu\n", (unsigned long)ns.lastConnectMs);
+  wPrintf(w, "ws_wifi_connect_max_ms %lu\n", (unsigned long)ns.maxConnectMs);
+  wPrintf(w, "ws_wifi_active_seconds %lu\n", (unsigned long)(ns.activeMs / 1000UL));
+  wPrintf(w, "ws_wifi_modem_sleep_seconds %lu\n", (unsigned long)(ns.sleepMs / 1000UL));
+  wPrintf(w, "ws_wifi_off_seconds %lu\n", (unsigned long)(ns.offMs / 1000UL));
+  wPrintf(w, "ws_alert_rules %u\n", (unsigned)as.rules);
+  wPrintf(w, "ws_alerts_active %d\n", __builtin_popcount(as.active));
+  wPrintf(w, "ws_alert_active_mask %lu\n", (unsigned long)as.active);
+  wPrintf(w, "ws_alert_rule_evals_total %lu\n", (unsigned long)as.ruleEvals);
+  wPrintf(w, "ws_alert_eval_last_us %lu\n", (unsigned long)as.lastUs);
+  wPrintf(w, "ws_alert_eval_max_us %lu\n", (unsigned long)as.maxUs);
+  wPrintf(w, "ws_ticker_depth %u\n", (unsigned)ts.depth);
+  wPrintf(w, "ws_ticker_max_depth %u\n", (unsigned)ts.maxDepth);
+  wPrintf(w, "ws_ticker_switches_total %lu\n", (unsigned long)ts.switches);
+  wPrintf(w, "ws_ticker_expired_total %lu\n", (unsigned long)ts.expired);
+  wPrintf(w, "ws_ticker_rejected_total %lu\n", (unsigned long)(ts.rejected + ts.evicted));
+  wPrintf(w, "ws_ticker_render_last_us %lu\n", (unsigned long)ts.renderUs);
+  wPrintf(w, "ws_ticker_frame_last_us %lu\n", (unsigned long)ts.frameUs);
+  wPrintf(w, "ws_ticker_frame_max_us %lu\n", (unsigned long)ts.frameMaxUs);
+  for (int i = 0; i < tmCount; ++i) {
+    wPrintf(w, "ws_ticker_message_shown_seconds{id=\"%d\",tag=\"%s\"} %lu\n", tm[i].id, tm[i].tag,
+            (unsigned long)(tm[i].shownMs / 1000UL));
+    wPrintf(w, "ws_ticker_message_last_show_ms{id=\"%d\",tag=\"%s\"} %lu\n", tm[i].id, tm[i].tag,
+            (unsigned long)tm[i].lastShowMs);
+    wPrintf(w, "ws_ticker_message_passes_total{id=\"%d\",tag=\"%s\"} %lu\n", tm[i].id, tm[i].tag,
+            (unsigned long)tm[i].passes);
+  }
+  wPrintf(w, "ws_graph_transitions_total %lu\n", (unsigned long)ga.transitions);
+  wPrintf(w, "ws_graph_anim_frames_total %lu\n", (unsigned long)ga.frames);
+  wPrintf(w, "ws_graph_anim_skipped_total %lu\n", (unsigned long)ga.skipped);
+  wPrintf(w, "ws_graph_anim_over_budget_total %lu\n", (unsigned long)ga.overBudget);
+  wPrintf(w, "ws_graph_anim_bands_total %lu\n", (unsigned long)ga.bands);
+  wPrintf(w, "ws_graph_anim_frame_last_us %lu\n", (unsigned long)ga.lastUs);
+  wPrintf(w, "ws_graph_anim_frame_max_us %lu\n", (unsigned long)ga.maxUs);
+  wPrintf(w, "ws_snapshot_age_seconds %ld\n", snapshotAge);
+  wPrintf(w, "ws_snapshot_fetched_epoch %lu\n", (unsigned long)fetchedAt);
+  wPrintf(w, "ws_frames_total %lu\n", (unsigned long)s_frames);
+  wPrintf(w, "ws_frame_last_us %lu\n", (unsigned long)s_frameLastUs);
+  wPrintf(w, "ws_frame_avg_us %lu\n", (unsigned long)s_frameAvgUs);
+  wPrintf(w, "ws_frame_max_us %lu\n", (unsigned long)s_frameMaxUs);
+  wPrintf(w, "ws_http_requests_total %lu\n", (unsigned long)s_requests);
+}
+
+// Prints a float as JSON (null for NAN)
+static void wJsonFloat(SockWriter &w, float v, int decimals) {
+  if (isnan(v)) wWrite(w, "null", 4);
+  else wPrintf(w, "%.*f", decimals, v);
+}
+
+static void sendForecastJson(SockWriter &w) {
+  static WeatherSnapshot snap; // server task only; too big for a small task stack
+  lockState();
+  snap = s_pubSnap;
+  unlockState();
+
+  wHeader(w, 200, "OK", "application/json");
+  wPrintf(w, "{\"valid\":%s,\"fetchedAt\":%lu,\"tz\":%ld,\"city\":",
+          snap.valid ? "true" : "false", (unsigned long)snap.fetchedAt, (long)snap.tzOffset);
+  wJsonString(w, snap.city);
+  wWrite(w, ",\"desc\":", 8);
+  wJsonString(w, snap.desc);
+  const WeatherDerived &d = snap.derived;
+  if (d.valid) {
+    wWrite(w, ",\"derived\":{\"temp\":", 19); wJsonFloat(w, d.nowTemp, 1);
+    wWrite(w, ",\"feels\":", 9); wJsonFloat(w, d.feelsLike, 1);
+    wWrite(w, ",\"trend3h\":", 11); wJsonFloat(w, d.trend3h, 1);
+    wWrite(w, ",\"hi\":", 6); wJsonFloat(w, d.todayHi, 1);
+    wWrite(w, ",\"lo\":", 6); wJsonFloat(w, d.todayLo, 1);
+    wPrintf(w, ",\"nextRain\":%lu}", (unsigned long)d.nextRainAt);
+  }
+  // slots as [dt, temp, wind, pop, humidity] rows to keep the payload small
+  wWrite(w, ",\"slots\":[", 10);
+  for (int i = 0; i < snap.count; ++i) {
+    const ForecastSlot &s = snap.slots[i];
+    wPrintf(w, "%s[%lu,", i ? "," : "", (unsigned long)s.dt);
+    wJsonFloat(w, s.temp, 1); wWrite(w, ",", 1);
+    wJsonFloat(w, s.wind, 1); wWrite(w, ",", 1);
+    wJsonFloat(w, s.pop, 2);
+    if (s.humidity >= 0) wPrintf(w, ",%d]", s.humidity);
+    else wWrite(w, ",null]", 6);
+  }
+  wWrite(w, "]}", 2);
+}
+
+// Same fixed layout the relay multicasts, so subscribers can poll a gateway over HTTP
+static void sendForecastBinary(SockWriter &w) {
+  static RelayPacket pkt;
+  lockState();
+  relayPack(s_pubSnap, pkt);
+  unlockState();
+  wHeader(w, 200, "OK", "application/octet-stream");
+  wWrite(w, &pkt, sizeof(pkt));
+}
+
+// -------------------------- request handling --------------------------
+static void serveClient(int fd) {
+  struct timeval tv = { 1, 0 };  // a stalled client only costs the server task 1 s
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+  static char req[512]; // one client at a time, like the writer below
+  size_t n = 0;
+  req[0] = 0;
+  while (n < sizeof(req) - 1) {
+    int r = recv(fd, req + n, sizeof(req) - 1 - n, 0);
+    if (r <= 0) break;
+    n += (size_t)r;
+    req[n] = 0;
+    if (strstr(req, "\r\n\r\n")) break;
+  }
+
+  static SockWriter w; // one client at a time
+  w.fd = fd; w.len = 0; w.ok = true;
+  s_requests = s_requests + 1;
+
+  // request line: "GET /path[?query] HTTP/1.x"
+  char *path = nullptr;
+  if (strncmp(req, "GET ", 4) == 0) {
+    path = req + 4;
+    char *end = strpbrk(path, " ?\r\n");
+    if (end) *end = 0;
+  }
+
+  if (!path)                                 { wHeader(w, 405, "Method Not Allowed", "text/plain"); }
+  else if (strcmp(path, "/metrics") == 0)      sendMetrics(w);
+  else if (strcmp(path, "/forecast") == 0)     sendForecastJson(w);
+  else if (strcmp(path, "/forecast.bin") == 0) sendForecastBinary(w);
+  else { wHeader(w, 404, "Not Found", "text/plain"); wPrintf(w, "try /metrics or /forecast\n"); }
+  wFlush(w);
+}
+
+static void serverLoop(void *arg) {
+  (void)arg;
+  for (;;) {
+    int c = accept(s_listenFd, nullptr, nullptr);
+    if (c < 0) { delay(100); continue; }
+    serveClient(c);
+    close(c);
+  }
+}
+
+bool initStatusServer(uint16_t port) {
+  s_listenFd = socket(AF_INET, SOCK_STREAM, 0);
+  if (s_listenFd < 0) {
+    Serial.println("StatusUtils: socket() failed");
+    return false;
+  }
+  int yes = 1;
+  setsockopt(s_listenFd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_ANY);
+  if (bind(s_listenFd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(s_listenFd, 2) != 0) {
+    Serial.printf("StatusUtils: cannot listen on port %u\n", port);
+    close(s_listenFd);
+    s_listenFd = -1;
+    return false;
+  }
+
+#if defined(ARDUINO_ARCH_ESP32)
+  s_lock = xSemaphoreCreateMutex();
+  xTaskCreatePinnedToCore(serverLoop, "status", 4096, nullptr, 1, nullptr, 0);
+#else
+  std::thread(serverLoop, nullptr).detach();
+#endif
+  Serial.printf("StatusUtils: serving /metrics and /forecast on port %u\n", port);
+  return true;
+}
@@ -0,0 +1,38 @@
+#ifndef STATUSUTILS_H
+#define STATUSUTILS_H
+
+#include <Arduino.h>
+
+/*
+  StatusUtils - LAN status endpoint for fleet monitoring
+    GET /metrics       -> Prometheus text: fetch latency, frame timing, heap, uptime, snapshot age
+    GET /forecast      -> current parsed snapshot as compact JSON
+    GET /forecast.bin  -> current snapshot as a RelayPacket (see RelayUtils.h)
+
+  The server runs in its own task (ESP32) or thread (host) on plain BSD sockets and
+  works from a private copy of the snapshot, so a slow client never touches loop().
+  Responses are formatted into one fixed 1460-byte segment buffer and sent as it fills.
+  Everything larger than a few words (request, copies of the published state) is static,
+  one client at a time, so the task gets by with 4 KB of stack; /metrics reports the
+  least it has had free (ws_status_stack_min_free_bytes, ESP32 only).
+*/
+
+// Start listening (call once Wi-Fi is up). Returns false if the socket cannot be opened.
+bool initStatusServer(uint16_t port = 80);
+
+// Copy the latest WeatherUtils snapshot into the server (call after each fetch)
+void statusPublishSnapshot();
+
+// Record the duration of one loop() pass that drew something (microseconds)
+void statusNoteFrame(uint32_t frameUs);
+
+// What statusNoteFrame() has recorded (also reported on /metrics)
+struct LoopFrameStats {
+  uint32_t frames;
+  uint32_t lastUs;
+  uint32_t avgUs;           // exponential moving average (1/16)
+  uint32_t maxUs;
+};
+LoopFrameStats getLoopFrameStats();
+
+#endif // STATUSUTILS_H
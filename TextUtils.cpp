@@ -0,0 +1,171 @@
+#include "TextUtils.h"
+#include <Adafruit_GFX.h>
+#include <Adafruit_ST7789.h>
+#include <Arduino.h>
+
+// extern screen declared in main sketch
+#include "DisplayUtils.h"  // extern DisplaySurface &screen
+
+// Classic font cell is 6x8 (5x7 glyph + spacing column and descender row)
+#define CELL_W TEXT_CELL_W
+#define CELL_H TEXT_CELL_H
+#define SLOT_PIXELS (CELL_W * TEXT_CACHE_MAX_SIZE * CELL_H * TEXT_CACHE_MAX_SIZE)
+
+// 1-bit masks at size 1, rasterized on first use (bit 5 = leftmost column)
+static uint8_t s_mask[256][CELL_H];
+static bool    s_maskReady[256];
+
+#if !DISPLAY_FRAMEBUFFER
+// Opaque glyph cache: fixed-size RGB565 slots, least recently used is replaced
+struct GlyphSlot {
+  bool     used;
+  uint8_t  c;
+  uint8_t  size;
+  uint16_t fg, bg;
+  uint32_t lastUse;
+};
+static GlyphSlot s_slots[TEXT_CACHE_SLOTS];
+static uint16_t  s_pixels[TEXT_CACHE_SLOTS][SLOT_PIXELS];
+static uint32_t  s_useClock = 0;
+#endif
+static TextCacheStats s_stats = {};
+
+static const uint8_t *glyphMask(uint8_t c) {
+  if (!s_maskReady[c]) {
+    // let GFX rasterize it so glyphs match screen.print() exactly (incl. the cp437 quirk)
+    static GFXcanvas1 canvas(CELL_W, CELL_H);
+    canvas.fillScreen(0);
+    canvas.drawChar(0, 0, c, 1, 0, 1);
+    for (int row = 0; row < CELL_H; ++row) {
+      uint8_t bits = 0;
+      for (int col = 0; col < CELL_W; ++col) {
+        if (canvas.getPixel(col, row)) bits |= 0x20 >> col;
+      }
+      s_mask[c][row] = bits;
+    }
+    s_maskReady[c] = true;
+  }
+  return s_mask[c];
+}
+
+#if !DISPLAY_FRAMEBUFFER
+static uint16_t *cachedGlyph(uint8_t c, uint8_t size, uint16_t fg, uint16_t bg) {
+  ++s_useClock;
+  int victim = 0;
+  for (int i = 0; i < TEXT_CACHE_SLOTS; ++i) {
+    GlyphSlot &s = s_slots[i];
+    if (s.used && s.c == c && s.size == size && s.fg == fg && s.bg == bg) {
+      s.lastUse = s_useClock;
+      s_stats.hits++;
+      return s_pixels[i];
+    }
+    if (!s.used) { if (s_slots[victim].used) victim = i; }
+    else if (s_slots[victim].used && s.lastUse < s_slots[victim].lastUse) victim = i;
+  }
+
+  // miss: expand the mask into the victim slot
+  s_stats.misses++;
+  if (s_slots[victim].used) s_stats.evictions++;
+  const uint8_t *m = glyphMask(c);
+  uint16_t *px = s_pixels[victim];
+  int w = CELL_W * size;
+  for (int row = 0; row < CELL_H; ++row) {
+    uint16_t *line = px + row * size * w;
+    for (int col = 0; col < CELL_W; ++col) {
+      uint16_t color = (m[row] & (0x20 >> col)) ? fg : bg;
+      for (int k = 0; k < size; ++k) line[col * size + k] = color;
+    }
+    for (int k = 1; k < size; ++k) memcpy(line + k * w, line, w * sizeof(uint16_t));
+  }
+  GlyphSlot &s = s_slots[victim];
+  s.used = true; s.c = c; s.size = size; s.fg = fg; s.bg = bg; s.lastUse = s_useClock;
+  return px;
+}
+#endif // !DISPLAY_FRAMEBUFFER
+
+// One writeFillRect per horizontal run; consecutive identical rows share a rect
+static void drawGlyphRuns(int16_t x, int16_t y, uint8_t c, uint8_t size, uint16_t fg) {
+  const uint8_t *m = glyphMask(c);
+  int row = 0;
+  while (row < CELL_H) {
+    uint8_t bits = m[row];
+    int rows = 1;
+    while (row + rows < CELL_H && m[row + rows] == bits) ++rows;
+    for (int col = 0; col < CELL_W;) {
+      if (!(bits & (0x20 >> col))) { ++col; continue; }
+      int start = col;
+      while (col < CELL_W && (bits & (0x20 >> col))) ++col;
+      screen.writeFillRect(x + start * size, y + row * size, (col - start) * size, rows * size, fg);
+    }
+    row += rows;
+  }
+}
+
+int16_t textWidth(const char *s, uint8_t size) {
+  if (size == 0) size = 1;
+  return (int16_t)(strlen(s) * CELL_W * size);
+}
+
+int16_t textDraw(int16_t x, int16_t y, const char *s, uint8_t size, uint16_t fg, uint16_t bg) {
+  if (size == 0) size = 1;
+  uint32_t t0 = micros();
+  int16_t cw = CELL_W * size, ch = CELL_H * size;
+  int16_t end = x + textWidth(s, size);
+  for (; *s && x < screen.width(); ++s, x += cw) {
+    if (x + cw <= 0) continue;
+    uint8_t c = (uint8_t)*s;
+#if !DISPLAY_FRAMEBUFFER
+    if (size <= TEXT_CACHE_MAX_SIZE) {
+      screen.drawRGBBitmap(x, y, cachedGlyph(c, size, fg, bg), cw, ch);
+      continue;
+    }
+#endif
+    // larger sizes, and the framebuffer (where fill + runs are row memsets anyway)
+    screen.startWrite();
+    screen.writeFillRect(x, y, cw, ch, bg);
+    drawGlyphRuns(x, y, c, size, fg);
+    screen.endWrite();
+    s_stats.runGlyphs++;
+  }
+  s_stats.lastUs = micros() - t0;
+  if (s_stats.lastUs > s_stats.maxUs) s_stats.maxUs = s_stats.lastUs;
+  return end;
+}
+
+int16_t textDrawTransparent(int16_t x, int16_t y, const char *s, uint8_t size, uint16_t fg) {
+  if (size == 0) size = 1;
+  int16_t cw = CELL_W * size;
+  int16_t end = x + textWidth(s, size);
+  screen.startWrite();
+  for (; *s && x < screen.width(); ++s, x += cw) {
+    if (x + cw <= 0) continue;
+    drawGlyphRuns(x, y, (uint8_t)*s, size, fg);
+  }
+  screen.endWrite();
+  return end;
+}
+
+int16_t textColumns(const char *s, uint8_t *cols, int16_t maxCols) {
+  int16_t n = 0;
+  for (; *s && n + CELL_W <= maxCols; ++s) {
+    const uint8_t *m = glyphMask((uint8_t)*s);
+    for (int col = 0; col < CELL_W; ++col, ++n) {
+      uint8_t bits = 0;
+      for (int row = 0; row < CELL_H; ++row) {
+        if (m[row] & (0x20 >> col)) bits |= 1 << row;
+      }
+      cols[n] = bits;
+    }
+  }
+  return n;
+}
+
+void textCacheClear() {
+#if !DISPLAY_FRAMEBUFFER
+  for (int i = 0; i < TEXT_CACHE_SLOTS; ++i) s_slots[i].used = false;
+#endif
+}
+
+const TextCacheStats &getTextCacheStats() {
+  return s_stats;
+}
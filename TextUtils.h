@@ -0,0 +1,60 @@
+#ifndef TEXTUTILS_H
+#define TEXTUTILS_H
+
+#include <Arduino.h>
+
+/*
+  TextUtils - cached text drawing for the classic 5x7 GFX font
+  - textDraw(): opaque text (fg on bg). Each glyph is rasterized once per size and
+    color pair into an RGB565 cache slot and pushed as one address-window burst,
+    instead of one fillRect per lit font pixel.
+  - textDrawTransparent(): text over existing pixels (graph labels). Lit pixels are
+    merged into horizontal runs, identical rows stacked, one fillRect per run.
+  Single-line text only; glyphs past the right edge are clipped (no wrapping).
+  Both return the x just past the last glyph, where tft.print() would leave the cursor.
+  Which path textDraw() takes depends on DISPLAY_FRAMEBUFFER (FramebufferUtils.h):
+  - 1, the default build: the RGB565 cache is compiled out (34 KB saved). Opaque glyphs
+    are a cell fill plus runs, i.e. row memsets in the index buffer; the panel sees
+    them only through displayFlush(). Host mock, per call: 3.5-5.5 us for the size-3
+    clock, 2-3.5 us for a size-2 box value or a size-1 title - the same range as the
+    cache path into the mock panel, which has no SPI cost.
+  - 0, drawing straight to the panel: glyphs up to TEXT_CACHE_MAX_SIZE come from the
+    cache, one address window each, which is where it pays off (one SPI transaction
+    instead of one per run).
+  getTextCacheStats() reports the path taken and the cost of the last textDraw().
+*/
+
+const uint8_t TEXT_CELL_W = 6;           // classic font cell at size 1
+const uint8_t TEXT_CELL_H = 8;
+const uint8_t TEXT_CACHE_SLOTS    = 40;
+const uint8_t TEXT_CACHE_MAX_SIZE = 3;   // larger sizes: background fill + runs
+
+struct TextCacheStats {
+  uint32_t hits;        // cache: always 0 with DISPLAY_FRAMEBUFFER
+  uint32_t misses;      // glyphs rasterized into a slot
+  uint32_t evictions;   // misses that replaced the least recently used slot
+  uint32_t runGlyphs;   // opaque glyphs drawn as cell fill + runs (framebuffer, large sizes)
+  uint32_t lastUs;      // last textDraw() call
+  uint32_t maxUs;
+};
+
+int16_t textWidth(const char *s, uint8_t size);
+int16_t textDraw(int16_t x, int16_t y, const char *s, uint8_t size, uint16_t fg, uint16_t bg);
+int16_t textDrawTransparent(int16_t x, int16_t y, const char *s, uint8_t size, uint16_t fg);
+
+inline int16_t textWidth(const String &s, uint8_t size) { return textWidth(s.c_str(), size); }
+inline int16_t textDraw(int16_t x, int16_t y, const String &s, uint8_t size, uint16_t fg, uint16_t bg) {
+  return textDraw(x, y, s.c_str(), size, fg, bg);
+}
+inline int16_t textDrawTransparent(int16_t x, int16_t y, const String &s, uint8_t size, uint16_t fg) {
+  return textDrawTransparent(x, y, s.c_str(), size, fg);
+}
+
+// Size-1 column bitmap of s (for pre-rendered strips): one byte per pixel column,
+// bit 0 = top row, TEXT_CELL_W columns per glyph. Returns the columns written.
+int16_t textColumns(const char *s, uint8_t *cols, int16_t maxCols);
+
+void textCacheClear();
+const TextCacheStats &getTextCacheStats();
+
+#endif // TEXTUTILS_H
@@ -0,0 +1,258 @@
+#include "TickerUtils.h"
+#include "TextUtils.h"      // textColumns(), TEXT_CELL_W/H
+#include "DisplayUtils.h"   // extern DisplaySurface &screen
+
+const int16_t TICKER_STRIP_COLS = TICKER_TEXT_LEN * TEXT_CELL_W;
+
+struct TickerMsg {
+  bool     used;
+  uint8_t  gen;             // bumped when the slot is freed, so stale ids miss
+  uint8_t  priority;
+  uint16_t color;
+  char     tag[TICKER_TAG_LEN];
+  char     text[TICKER_TEXT_LEN + 1];
+  uint8_t  cols[TICKER_STRIP_COLS];
+  int16_t  colCount;
+  bool     expires;
+  uint32_t expiresAt;       // millis()
+  uint16_t passesLeft;      // 0 = unlimited
+  uint32_t postSeq;         // eviction picks the oldest of the lowest priority
+  uint32_t passes;
+  uint32_t shownMs;
+  uint32_t lastShowMs;
+};
+
+static TickerMsg s_msgs[TICKER_MAX_MSGS];
+static uint32_t s_postSeq = 0;
+
+static int16_t  s_viewW = 320;
+static uint8_t  s_size = 1;
+static uint16_t s_bg = 0;
+
+// What is on screen: a copy of the message's strip, so queue changes wait for the next pass
+static uint8_t  s_show[TICKER_STRIP_COLS];
+static int16_t  s_showCols = 0;
+static uint16_t s_showColor = 0;
+static int      s_showId = -1;          // -1 = nothing on screen
+static int      s_lastSlot = -1;        // round-robin position among equal priorities
+static uint8_t  s_showPriority = 0;
+static int16_t  s_x = 0;
+static uint32_t s_showSince = 0;
+static bool     s_preempt = false;
+static bool     s_drawn = false;        // text rows hold pixels (cleared once when idle)
+
+static TickerStats s_stats = {};
+
+static TickerMsg *find(int id) {
+  if (id < 0) return nullptr;
+  TickerMsg &m = s_msgs[id % TICKER_MAX_MSGS];
+  return (m.used && m.gen == (uint8_t)(id / TICKER_MAX_MSGS)) ? &m : nullptr;
+}
+
+static int idOf(int slot) {
+  return s_msgs[slot].gen * TICKER_MAX_MSGS + slot;
+}
+
+static void release(TickerMsg &m) {
+  m.used = false;
+  m.gen++;
+  s_stats.depth--;
+}
+
+// Measure and rasterize once; frames only copy columns
+static void render(TickerMsg &m, const char *text) {
+  uint32_t t0 = micros();
+  strlcpy(m.text, text, sizeof(m.text));
+  m.colCount = textColumns(m.text, m.cols, TICKER_STRIP_COLS);
+  s_stats.renderUs = micros() - t0;
+}
+
+void initTicker(int16_t viewW, uint8_t textSize, uint16_t bg) {
+  s_viewW = viewW;
+  s_size = textSize ? textSize : 1;
+  s_bg = bg;
+  s_x = viewW;
+}
+
+int tickerPost(const char *tag, const char *text, uint8_t priority, uint16_t color,
+               uint32_t ttlMs, uint16_t passes) {
+  int slot = -1;
+  for (int i = 0; i < TICKER_MAX_MSGS; ++i) {
+    if (!s_msgs[i].used) { slot = i; break; }
+  }
+  if (slot < 0) {
+    // full: the oldest message of the lowest priority makes room, if it ranks below
+    int victim = 0;
+    for (int i = 1; i < TICKER_MAX_MSGS; ++i) {
+      const TickerMsg &a = s_msgs[i], &b = s_msgs[victim];
+      if (a.priority < b.priority || (a.priority == b.priority && a.postSeq < b.postSeq)) victim = i;
+    }
+    if (s_msgs[victim].priority >= priority) {
+      s_stats.rejected++;
+      return -1;
+    }
+    release(s_msgs[victim]);
+    s_stats.evicted++;
+    slot = victim;
+  }
+
+  TickerMsg &m = s_msgs[slot];
+  uint8_t gen = m.gen;
+  memset(&m, 0, sizeof(m));
+  m.used = true;
+  m.gen = gen;
+  m.priority = priority;
+  m.color = color;
+  strlcpy(m.tag, tag, sizeof(m.tag));
+  m.expires = ttlMs > 0;
+  m.expiresAt = millis() + ttlMs;
+  m.passesLeft = passes;
+  m.postSeq = ++s_postSeq;
+  render(m, text);
+
+  s_stats.posts++;
+  s_stats.depth++;
+  if (s_stats.depth > s_stats.maxDepth) s_stats.maxDepth = s_stats.depth;
+  if (s_showId >= 0 && priority > s_showPriority) s_preempt = true;
+  return idOf(slot);
+}
+
+bool tickerUpdate(int id, const char *text, uint16_t color) {
+  TickerMsg *m = find(id);
+  if (!m) return false;
+  m->color = color;
+  if (strncmp(m->text, text, TICKER_TEXT_LEN) != 0) {
+    render(*m, text);
+    s_stats.updates++;
+  }
+  return true;
+}
+
+bool tickerRemove(int id) {
+  TickerMsg *m = find(id);
+  if (!m) return false;
+  release(*m);
+  return true;
+}
+
+bool tickerQueued(int id) {
+  return find(id) != nullptr;
+}
+
+void tickerRestart() {
+  s_x = s_viewW;
+}
+
+// The message on screen is done (scrolled off, or preempted: not a complete pass)
+static void endShowing(uint32_t nowMs, bool completed) {
+  TickerMsg *m = find(s_showId);
+  s_showId = -1;
+  if (!m) return;   // removed or replaced while on screen
+  uint32_t shown = nowMs - s_showSince;
+  m->shownMs += shown;
+  m->lastShowMs = shown;
+  if (!completed) return;
+  m->passes++;
+  if (m->passesLeft > 0 && --m->passesLeft == 0) {
+    release(*m);
+    s_stats.expired++;
+  }
+}
+
+static bool showNext(uint32_t nowMs) {
+  int best = -1;
+  for (int k = 1; k <= TICKER_MAX_MSGS; ++k) {
+    int i = (s_lastSlot + k + TICKER_MAX_MSGS) % TICKER_MAX_MSGS;
+    TickerMsg &m = s_msgs[i];
+    if (!m.used) continue;
+    if (m.expires && (int32_t)(nowMs - m.expiresAt) >= 0) {
+      release(m);
+      s_stats.expired++;
+      continue;
+    }
+    if (best < 0 || m.priority > s_msgs[best].priority) best = i;
+  }
+  if (best < 0) return false;
+
+  TickerMsg &m = s_msgs[best];
+  memcpy(s_show, m.cols, m.colCount);
+  s_showCols = m.colCount;
+  s_showColor = m.color;
+  s_showPriority = m.priority;
+  s_showId = idOf(best);
+  s_lastSlot = best;
+  s_showSince = nowMs;
+  s_x = s_viewW;
+  s_stats.switches++;
+  return true;
+}
+
+// Visible strip columns, scaled: identical neighbouring columns share a rect,
+// one rect per vertical run of lit rows
+static void blit(int16_t y) {
+  int16_t sz = s_size;
+  int16_t c = s_x < 0 ? (int16_t)(-s_x / sz) : 0;
+  int16_t end = (int16_t)min((int32_t)s_showCols, ((int32_t)s_viewW - s_x + sz - 1) / sz);
+  while (c < end) {
+    uint8_t bits = s_show[c];
+    int16_t run = 1;
+    while (c + run < end && s_show[c + run] == bits) ++run;
+    for (int row = 0; bits && row < TEXT_CELL_H;) {
+      if (!(bits & (1 << row))) { ++row; continue; }
+      int start = row;
+      while (row < TEXT_CELL_H && (bits & (1 << row))) ++row;
+      screen.writeFillRect(s_x + c * sz, y + start * sz, run * sz, (row - start) * sz, s_showColor);
+    }
+    c += run;
+  }
+}
+
+bool tickerFrame(int16_t y, int16_t speed, uint32_t nowMs) {
+  uint32_t t0 = micros();
+  int16_t h = TEXT_CELL_H * s_size;
+  if (s_preempt && s_showId >= 0) endShowing(nowMs, false);
+  s_preempt = false;
+  if (s_showId >= 0 && s_x + s_showCols * s_size <= 0) endShowing(nowMs, true);
+  if (s_showId < 0 && !showNext(nowMs)) {
+    if (s_drawn) screen.fillRect(0, y, s_viewW, h, s_bg);
+    s_drawn = false;
+    return false;
+  }
+
+  screen.startWrite();
+  screen.writeFillRect(0, y, s_viewW, h, s_bg);
+  blit(y);
+  screen.endWrite();
+  s_drawn = true;
+  s_x -= speed;
+
+  s_stats.frameUs = micros() - t0;
+  if (s_stats.frameUs > s_stats.frameMaxUs) s_stats.frameMaxUs = s_stats.frameUs;
+  return true;
+}
+
+int tickerMessages(TickerMessageInfo *out, int max) {
+  int n = 0;
+  for (int i = 0; i < TICKER_MAX_MSGS; ++i) {
+    const TickerMsg &m = s_msgs[i];
+    if (!m.used) continue;
+    if (n < max) {
+      TickerMessageInfo &o = out[n];
+      o.id = idOf(i);
+      strlcpy(o.tag, m.tag, sizeof(o.tag));
+      o.priority = m.priority;
+      o.widthPx = (uint16_t)(m.colCount * s_size);
+      o.passesLeft = m.passesLeft;
+      o.passes = m.passes;
+      o.shownMs = m.shownMs;
+      o.lastShowMs = m.lastShowMs;
+      o.onScreen = o.id == s_showId;
+    }
+    ++n;
+  }
+  return n;
+}
+
+const TickerStats &getTickerStats() {
+  return s_stats;
+}
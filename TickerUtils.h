@@ -0,0 +1,78 @@
+#ifndef TICKERUTILS_H
+#define TICKERUTILS_H
+
+#include <Arduino.h>
+
+/*
+  TickerUtils - multi-message scrolling ticker (classic font, one line)
+  - A fixed queue of TICKER_MAX_MSGS messages. Each has a priority, an optional
+    time to live and an optional number of passes, after which it is dropped.
+  - Posting (or updating) a message measures it and renders it once into a size-1
+    column strip (one byte per pixel column, see textColumns()). Frames only blit
+    the visible columns of that strip, scaled, as vertical runs: no string work,
+    no getTextBounds() per frame.
+  - The message on screen scrolls from the right edge until it has fully left; the
+    next one is then picked: the highest priority wins, equal priorities take turns.
+    A post with a higher priority than the message on screen replaces it at once.
+  - The strip on screen is a copy, so updating or removing the message being shown
+    takes effect on its next pass instead of jumping mid-scroll.
+*/
+
+const uint8_t TICKER_MAX_MSGS = 8;
+const uint8_t TICKER_TEXT_LEN = 120;   // characters kept per message (longer text is cut)
+const uint8_t TICKER_TAG_LEN  = 12;
+
+const uint8_t TICKER_PRIO_LOW    = 0;
+const uint8_t TICKER_PRIO_NORMAL = 1;
+const uint8_t TICKER_PRIO_ALERT  = 2;
+
+// View width in pixels, text size and background (call once the panel is set up)
+void initTicker(int16_t viewW, uint8_t textSize, uint16_t bg);
+
+// Adds a message; returns its id, or -1 when the queue is full of messages of the same
+// or higher priority (otherwise the lowest-priority one is dropped to make room).
+// ttlMs 0 = no expiry, passes 0 = until removed.
+int tickerPost(const char *tag, const char *text, uint8_t priority, uint16_t color,
+               uint32_t ttlMs = 0, uint16_t passes = 0);
+// New text (and color) for a message; false when the id is no longer queued
+bool tickerUpdate(int id, const char *text, uint16_t color);
+bool tickerRemove(int id);
+bool tickerQueued(int id);
+
+// One frame at row y: draws the message on screen, then moves it speed pixels left.
+// Returns false when the queue is empty (nothing drawn).
+bool tickerFrame(int16_t y, int16_t speed, uint32_t nowMs);
+
+// Restart the message on screen from the right edge
+void tickerRestart();
+
+struct TickerMessageInfo {
+  int      id;
+  char     tag[TICKER_TAG_LEN];
+  uint8_t  priority;
+  uint16_t widthPx;         // scaled pixel width, measured on post/update
+  uint16_t passesLeft;      // 0 = unlimited
+  uint32_t passes;          // complete passes shown
+  uint32_t shownMs;         // total time on screen (completed showings)
+  uint32_t lastShowMs;      // duration of the last showing
+  bool     onScreen;
+};
+// Fills up to max entries (queue order); returns the number of messages queued
+int tickerMessages(TickerMessageInfo *out, int max);
+
+struct TickerStats {
+  uint8_t  depth;           // messages queued
+  uint8_t  maxDepth;
+  uint32_t posts;
+  uint32_t updates;
+  uint32_t rejected;        // posts refused (queue full)
+  uint32_t evicted;         // messages dropped for a higher-priority post
+  uint32_t expired;         // dropped by time to live or pass count
+  uint32_t switches;        // messages brought on screen
+  uint32_t renderUs;        // last strip render (post/update)
+  uint32_t frameUs;         // last frame blit
+  uint32_t frameMaxUs;
+};
+const TickerStats &getTickerStats();
+
+#endif // TICKERUTILS_H
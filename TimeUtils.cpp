@@ -1,27 +1,54 @@
 #include "TimeUtils.h"
-#include <WiFi.h>
+#include "NetUtils.h"
 #include "time.h"
+#if defined(ARDUINO_ARCH_ESP32)
+#include "esp_sntp.h"
+#endif
 
-void initTimeModule(const char* ssid, const char* password, long gmtOffset, int dstOffset) {
-  // NOTE: caller should have Serial.begin() already to see prints.
-  Serial.println("[TimeUtils] initTimeModule() starting...");
+static long s_gmtOffset = 0;
+static int s_dstOffset = 0;
+static volatile uint32_t s_syncCount = 0;     // SNTP sync events (incl. lwIP's own periodic ones)
+static volatile uint32_t s_lastSyncMs = 0;    // millis() of the last sync (if s_syncCount > 0)
 
-  // 1) Connect to Wi-Fi with a timeout (non-infinite)
-  Serial.print("[TimeUtils] WiFi.begin()");
-  WiFi.begin(ssid, password);
+static void noteSync() {
+  s_lastSyncMs = millis();
+  s_syncCount = s_syncCount + 1;
+}
 
-  const unsigned long wifiTimeoutMs = 20UL * 1000UL; // 20 seconds
-  unsigned long wifiStart = millis();
-  while (WiFi.status() != WL_CONNECTED && (millis() - wifiStart) < wifiTimeoutMs) {
-    delay(250);
-    Serial.print('.'); // progress
-  }
-  Serial.println();
+#if defined(ARDUINO_ARCH_ESP32)
+static void onSntpSync(struct timeval *tv) {
+  (void)tv;
+  noteSync();
+}
+#endif
 
-  if (WiFi.status() == WL_CONNECTED) {
-    Serial.print("[TimeUtils] WiFi connected, IP=");
-    Serial.println(WiFi.localIP());
-  } else {
+// NetUtils wake hook: the link is up for someone else, resync if it is due
+static void resyncIfDue() {
+  if (s_syncCount != 0 && (uint32_t)(millis() - s_lastSyncMs) < TIME_RESYNC_MS) return;
+  uint32_t before = s_syncCount;
+  configTime(s_gmtOffset, s_dstOffset, "pool.ntp.org", "time.nist.gov"); // restarts SNTP
+#if defined(ARDUINO_ARCH_ESP32)
+  // wait a little so the request goes out before the radio idles again
+  const unsigned long resyncWaitMs = 3UL * 1000UL;
+  uint32_t start = millis();
+  while (s_syncCount == before && (uint32_t)(millis() - start) < resyncWaitMs) delay(50);
+#else
+  noteSync();
+#endif
+  Serial.println(s_syncCount != before ? "[TimeUtils] NTP resynced" : "[TimeUtils] NTP resync pending");
+}
+
+void initTimeModule(long gmtOffset, int dstOffset) {
+  // NOTE: caller should have Serial.begin() already to see prints.
+  Serial.println("[TimeUtils] initTimeModule() starting...");
+  s_gmtOffset = gmtOffset;
+  s_dstOffset = dstOffset;
+#if defined(ARDUINO_ARCH_ESP32)
+  sntp_set_time_sync_notification_cb(onSntpSync);
+#endif
+
+  // 1) Bring the link up (NetUtils connects with a timeout, non-infinite)
+  if (!netAcquire("time")) {
     Serial.println("[TimeUtils] WARNING: WiFi not connected after timeout. Continuing (some features may not work).");
   }
 
@@ -32,18 +59,20 @@ void initTimeModule(const char* ssid, const char* password, long gmtOffset, int
 
   // 3) Wait briefly for NTP sync (but do not block forever)
   const unsigned long ntpTimeoutMs = 8UL * 1000UL; // 8 seconds
-  unsigned long ntpStart = millis();
+  uint32_t ntpStart = millis();
   struct tm timeinfo;
   bool synced = false;
-  while ((millis() - ntpStart) < ntpTimeoutMs) {
+  while ((uint32_t)(millis() - ntpStart) < ntpTimeoutMs) {
     if (getLocalTime(&timeinfo)) {
       synced = true;
       break;
     }
     delay(250);
   }
+  netRelease("time");
 
   if (synced) {
+    if (s_syncCount == 0) noteSync();
     char buf[64];
     strftime(buf, sizeof(buf), "%c", &timeinfo);
     Serial.print("[TimeUtils] NTP time set: ");
@@ -52,6 +81,8 @@ void initTimeModule(const char* ssid, const char* password, long gmtOffset, int
     Serial.println("[TimeUtils] WARNING: NTP time not acquired within timeout. Time functions will return unavailable until NTP syncs.");
   }
 
+  // later resyncs piggyback on whoever wakes the radio next (forecast fetch)
+  netOnWake(resyncIfDue);
   Serial.println("[TimeUtils] initTimeModule() finished.");
 }
 
@@ -3,16 +3,20 @@
 
 #include <Arduino.h>
 
+// NTP is re-synced at most this often, and only while the link is up anyway (see NetUtils)
+const unsigned long TIME_RESYNC_MS = 6UL * 3600UL * 1000UL;
+
 /**
- * Initialize Wi-Fi and NTP time sync.
- * - ssid / password: WiFi credentials
+ * Initialize NTP time sync. Call initNet() first.
  * - gmtOffset: seconds offset from UTC (e.g. -4*3600 for EDT)
  * - dstOffset: daylight seconds (usually 0 or 3600)
  *
- * This function will attempt to connect to Wi-Fi for a limited time and
+ * This function brings the link up through NetUtils for a limited time and
  * will attempt to sync NTP time for a limited time. It will not block forever.
+ * Later resyncs run from a NetUtils wake hook, so they share the radio wake-up
+ * of the next forecast fetch instead of powering the radio up on their own.
  */
-void initTimeModule(const char* ssid, const char* password, long gmtOffset, int dstOffset);
+void initTimeModule(long gmtOffset, int dstOffset);
 
 /**
  * Return the current local time as a formatted string: "HH:MM:SS AM" or "--:--:--" if not available.
@@ -1,10 +1,11 @@
 #include "UIUtils.h"
+#include "TextUtils.h"
 #include <Adafruit_GFX.h>
 #include <Adafruit_ST7789.h>
 #include <Arduino.h>
 
 // Externs (these are defined in your main sketch)
-extern Adafruit_ST7789 tft;
+#include "DisplayUtils.h"  // extern DisplaySurface &screen
 extern int SCREEN_W;
 extern int SCREEN_H;
 extern uint8_t clockTextSize;
@@ -15,26 +16,31 @@ extern int clockX;
 extern int clockYOffset;
 
 // Draw the clock neatly in the bottom-left.
-// Clears a band area using clockBandHeight and clockTextPaddingY and then prints the provided string.
+// The glyph cells are opaque (cached, see TextUtils), so only the band around them is cleared.
 void drawClockBottom(const String &timeStr) {
   // Compute Y baseline for text
   int bandTop = SCREEN_H - clockBandHeight;
-  // Clear the whole band
-  tft.fillRect(0, bandTop, SCREEN_W, clockBandHeight, ST77XX_BLACK);
 
   // Draw a faint divider line
-  tft.drawFastHLine(0, bandTop, SCREEN_W, ST77XX_WHITE);
+  screen.drawFastHLine(0, bandTop, SCREEN_W, ST77XX_WHITE);
 
-  // Set text properties and draw
-  tft.setTextSize(clockTextSize);
-  tft.setTextColor(ST77XX_CYAN);
   // Compute Y cursor: bandTop + padding + optional offset
   int cursorY = bandTop + clockTextPaddingY + clockYOffset;
   if (cursorY < 0) cursorY = 0;
   if (cursorY > SCREEN_H - 8) cursorY = SCREEN_H - 8;
 
-  tft.setCursor(clockX, cursorY);
-  tft.print(timeStr);
+  // Clear the band except where the text cells will land (above, below, left, right)
+  int textH = 8 * clockTextSize;
+  int textEnd = clockX + textWidth(timeStr, clockTextSize);
+  int bandY = bandTop + 1;
+  int textTop = max(cursorY, bandY);
+  int textBot = min(cursorY + textH, SCREEN_H);
+  if (textTop > bandY) screen.fillRect(0, bandY, SCREEN_W, textTop - bandY, ST77XX_BLACK);
+  if (textBot < SCREEN_H) screen.fillRect(0, textBot, SCREEN_W, SCREEN_H - textBot, ST77XX_BLACK);
+  if (clockX > 0) screen.fillRect(0, textTop, clockX, textBot - textTop, ST77XX_BLACK);
+  if (textEnd < SCREEN_W) screen.fillRect(textEnd, textTop, SCREEN_W - textEnd, textBot - textTop, ST77XX_BLACK);
+
+  textDraw(clockX, cursorY, timeStr, clockTextSize, ST77XX_CYAN, ST77XX_BLACK);
 
   // If you want to show a small timezone or AM/PM indicator elsewhere, add here.
 }
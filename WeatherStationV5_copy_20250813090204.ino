@@ -23,6 +23,15 @@
 #include "GraphUtils.h"   // calculateGraphDataFromForecast(...), drawGraph(graphIndex)
 #include "LeftBoxUtils.h" // calculateLeftBoxData(...), drawLeftBoxes()
 #include "UIUtils.h"      // drawBox(), drawLabel(), useful UI helpers
+#include "HistoryUtils.h" // initHistory(), recordHistoryFromSnapshot()
+#include "LedUtils.h"     // initLedEngine(), ledUpdateFromSnapshot(), ledService()
+#include "StatusUtils.h"  // initStatusServer(): /metrics and /forecast on the LAN
+#include "RelayUtils.h"   // RelayRole: share one OpenWeather fetch across stations
+#include "DisplayUtils.h" // DisplayDriver: ST7789 on the DMA transport (DisplayDmaUtils)
+#include "NetUtils.h"     // initNet(): Wi-Fi woken on demand, idled between fetches
+#include "AlertUtils.h"   // initAlerts(), alertsUpdate(): threshold alerts over the snapshot
+#include "TickerUtils.h"  // tickerPost(), tickerFrame(): message queue for the small ticker
+#include "ConsoleUtils.h" // consoleService(): serial console for live tuning (help)
 
 // ----- TFT pins and object (Waveshare ESP32S3 1.9") -----
 #define TFT_CS    12
@@ -32,7 +41,16 @@
 #define TFT_MOSI  13
 #define TFT_SCLK  10
 #define TFT_MISO   2
-Adafruit_ST7789 tft = Adafruit_ST7789(TFT_CS, TFT_DC, TFT_RST);
+DisplayDriver tft = DisplayDriver(TFT_CS, TFT_DC, TFT_RST);
+
+// Everything is drawn into `screen`: an 8-bit indexed framebuffer pushed to the panel
+// by displayFlush() (FramebufferUtils), or the panel itself with DISPLAY_FRAMEBUFFER 0
+#if DISPLAY_FRAMEBUFFER
+IndexedFramebuffer frame(320, 170);
+DisplaySurface &screen = frame;
+#else
+DisplaySurface &screen = tft;
+#endif
 
 // ----- LED strip (unchanged) -----
 #define LEDS_COUNT  2
@@ -45,6 +63,25 @@ Freenove_ESP32_WS2812 strip = Freenove_ESP32_WS2812(LEDS_COUNT, LEDS_PIN, CHANNE
 const char* WIFI_SSID     = "You SSID here";
 const char* WIFI_PASSWORD = "Wireless Network password here";
 const char* OPENWEATHER_KEY = "your API key here"; // or put in WeatherUtils init
+char weatherCity[48] = "Groton,CT,US";              // OpenWeather q= (console: set city)
+
+// Forecast relay: one GATEWAY station fetches OpenWeather and multicasts the snapshot;
+// SUBSCRIBER stations need no API key (RELAY_GATEWAY_HOST = HTTP fallback, "" = none)
+const RelayRole STATION_RELAY_ROLE = RELAY_ROLE_DIRECT;
+const char* RELAY_GATEWAY_HOST = "";
+
+// Radio between fetches: MODEM_SLEEP keeps the status server and relay reachable;
+// RADIO_OFF saves the most (reconnects every WEATHER_REFRESH_MS) but the LAN endpoints
+// only answer during fetches, so relay gateways/subscribers fall back to MODEM_SLEEP
+const NetPowerMode STATION_NET_POWER = NET_POWER_MODEM_SLEEP;
+
+// Alerts take over the ticker and flash the LEDs while active. One rule per line:
+//   <name>: <field> <op> <number> : <message>   ("%v" = value; syntax in AlertUtils.h)
+const char* ALERT_RULES =
+  "rain:   max(pop, 3h) >= 60       : Rain %v% in the next 3 h\n"
+  "wind:   max(wind, 6h) > 25       : Wind up to %v mph\n"
+  "freeze: min(temp, tonight) <= 32 : Freeze tonight, low %vF\n"
+  "heat:   feels >= 95              : Heat: feels like %vF\n";
 
 // Eastern US example: EDT/EST handling is done in TimeUtils (configTime or TZ string)
 const long GMT_OFFSET = -5 * 3600; // change as appropriate or use TZ strings
@@ -72,10 +109,9 @@ int leftBoxX, leftBoxY, leftBoxW, leftBoxH; // middle-left stat area
 // ----- Scrolling small ticker (top 20%) -----
 const uint8_t scrollSmallTextSize = 3; // same as clock default; changeable
 int scrollSmallY;                      // computed from TOP_BAND_H
-int scrollSmallX;                      // current X position for small ticker
 int scrollSmallSpeed = 3;              // pixels per tick (smaller = slower)
-const unsigned long smallScrollInterval = 40; // ms between small-ticker frame updates
-unsigned long lastSmallScrollMs = 0;
+unsigned long smallScrollInterval = 40; // ms between small-ticker frame updates
+uint32_t lastSmallScrollMs = 0;
 
 // ----- Main (large) scrolling marquee (optional) -----
 // If you keep the big marquee from v4, keep these. Otherwise, leave empty.
@@ -86,28 +122,62 @@ int16_t scrollX_main, scrollY_main;
 unsigned long lastMainScrollMs = 0;
 const unsigned long mainScrollInterval = 40;
 
-// ----- Scrolling messages (String so we can update msgs[1] with weather) -----
-String msg0 = "Good things are coming";
-String msg1 = "Loading weather...";
-String msg2 = "Check USAJobs->EB->GovConnect->MyCAA too!";
-String msgs[] = { msg0, msg1, msg2 };
-const uint8_t MSG_COUNT = sizeof(msgs) / sizeof(msgs[0]);
-uint8_t currentMsg = 0;
-String curMsg = msgs[0];
+// ----- Scrolling messages (TickerUtils queue) -----
+// Custom messages take turns with the weather report; active alerts take the ticker over
+const char* TICKER_CUSTOM[] = {
+  "Good things are coming",
+  "Check USAJobs->EB->GovConnect->MyCAA too!",
+};
+int tickerWeatherId = -1;
+int tickerAlertId = -1;
 
 // ----- Graph rotation & scheduling (millis-based) -----
-unsigned long lastWeatherCheckMs = 0;
-const unsigned long WEATHER_REFRESH_MS = 10UL * 60UL * 1000UL; // 10 minutes
-unsigned long lastGraphSwitchMs = 0;
-const unsigned long GRAPH_SWITCH_MS = 2UL * 60UL * 1000UL;     // 2 minutes
+// Timers are uint32_t like millis() on the ESP32, so `now - last` stays right across
+// the 49.7-day wrap (also in host builds, where unsigned long is 64-bit)
+uint32_t lastWeatherCheckMs = 0;
+unsigned long WEATHER_REFRESH_MS = 10UL * 60UL * 1000UL; // 10 minutes
+uint32_t lastGraphSwitchMs = 0;
+unsigned long GRAPH_SWITCH_MS = 2UL * 60UL * 1000UL;     // 2 minutes
 int graphIndex = 0;
-const int NUM_GRAPHS = 2; // 0=temp, 1=wind (extend later)
+// NUM_GRAPHS comes from GraphUtils.h (one per metric in GraphMetricList)
 
 // ----- Clock update scheduling (we update chars efficiently) -----
-unsigned long lastClockUpdateMs = 0;
+uint32_t lastClockUpdateMs = 0;
 unsigned long clockUpdateIntervalMs = 500; // check twice/sec (or 1000ms for once/sec)
 String prevClockText = "";
 
+// ----- Serial console (ConsoleUtils): tunables changed without reflashing -----
+// Periods above are not const for this. Values saved with "save" are loaded over the
+// defaults at boot; the middle-area layout follows clockBandHeight after a reboot.
+void onWeatherRefreshChanged() {
+  setWeatherCacheMs(WEATHER_REFRESH_MS);
+}
+
+void onCityChanged() {
+  setWeatherCity(weatherCity);
+  lastWeatherCheckMs = millis() - WEATHER_REFRESH_MS; // fetch the new city on the next pass
+}
+
+void onClockLayoutChanged() {
+  // clear everything below the middle area, then let the clock redraw in the new layout
+  int top = leftBoxY + leftBoxH;
+  screen.fillRect(0, top, SCREEN_W, SCREEN_H - top, ST77XX_BLACK);
+  prevClockText = "";
+}
+
+const ConsoleVar CONSOLE_VARS[] = {
+  { "scrollSmallSpeed",    "tk_speed", CONSOLE_INT,   &scrollSmallSpeed,    1,     24,        nullptr },
+  { "smallScrollInterval", "tk_ms",    CONSOLE_ULONG, &smallScrollInterval, 10,    1000,      nullptr },
+  { "GRAPH_SWITCH_MS",     "graph_ms", CONSOLE_ULONG, &GRAPH_SWITCH_MS,     5000,  3600000,   nullptr },
+  { "WEATHER_REFRESH_MS",  "wx_ms",    CONSOLE_ULONG, &WEATHER_REFRESH_MS,  60000, 86400000,  onWeatherRefreshChanged },
+  { "city",                "city",     CONSOLE_STR,   weatherCity,          0,     sizeof(weatherCity), onCityChanged },
+  { "clockTextSize",       "clk_size", CONSOLE_U8,    &clockTextSize,       1,     4,         onClockLayoutChanged },
+  { "clockTextPaddingY",   "clk_pad",  CONSOLE_U8,    &clockTextPaddingY,   0,     20,        onClockLayoutChanged },
+  { "clockBandHeight",     "clk_band", CONSOLE_U8,    &clockBandHeight,     10,    40,        onClockLayoutChanged },
+  { "clockX",              "clk_x",    CONSOLE_INT,   &clockX,              0,     200,       onClockLayoutChanged },
+  { "clockYOffset",        "clk_yoff", CONSOLE_INT,   &clockYOffset,        -20,   20,        onClockLayoutChanged },
+};
+
 // ----- Prototypes for helper functions (implemented in helper .cpp files) -----
 // WeatherUtils.h should provide these:
 //   void initWeather(const char* apiKey, const char* cityQuery, unsigned long cacheMillis);
@@ -127,26 +197,63 @@ String prevClockText = "";
 //   void drawHeaderBox(...), drawLabel(...), drawValue(...)
 
 // TimeUtils.h provides:
-//   void initTimeModule(const char* ssid, const char* pwd, long gmtOffset, int dstOffset);
+//   void initTimeModule(long gmtOffset, int dstOffset); // after initNet()
 //   String getTimeString();
 //   bool getLocalTime(struct tm* out); // if needed by helpers
 
+// Weather report changed: re-render its ticker message (no-op when the text is the same)
+void applyWeatherReport() {
+  tickerUpdate(tickerWeatherId, getWeatherReport().c_str(), ST77XX_CYAN);
+}
+
+// Alert set changed: post/update/drop the alert message (its priority puts it on
+// screen at once), start/stop the LED flash
+void applyAlerts() {
+  uint8_t r, g, b;
+  bool on = alertsLedColor(r, g, b);
+  ledSetAlert(on, r, g, b);
+  if (alertsActiveCount() == 0) {
+    tickerRemove(tickerAlertId);
+    tickerAlertId = -1;
+  } else if (!tickerUpdate(tickerAlertId, alertsTickerText().c_str(), ST77XX_RED)) {
+    tickerAlertId = tickerPost("alerts", alertsTickerText().c_str(), TICKER_PRIO_ALERT, ST77XX_RED);
+  }
+}
+
 // ----- Setup: initialize peripherals, layout, modules -----
 void setup() {
   Serial.begin(115200);
   delay(100);
   Serial.println("=== WeatherStation V5 BOOT ===");
 
-  // init time (also connects Wi-Fi inside TimeUtils)
+  // console first: saved tunables replace the defaults before anything uses them
+  initConsole(CONSOLE_VARS, sizeof(CONSOLE_VARS) / sizeof(CONSOLE_VARS[0]));
+
+  // Wi-Fi is brought up on demand by NetUtils (relays must stay associated)
+  NetPowerMode netPower = STATION_NET_POWER;
+  if (netPower == NET_POWER_RADIO_OFF && STATION_RELAY_ROLE != RELAY_ROLE_DIRECT) netPower = NET_POWER_MODEM_SLEEP;
+  initNet(WIFI_SSID, WIFI_PASSWORD, netPower);
+
+  // init time (first netAcquire() connects Wi-Fi)
   Serial.println("Init time module (this connects Wi-Fi)...");
-  initTimeModule(WIFI_SSID, WIFI_PASSWORD, GMT_OFFSET, DST_OFFSET);
+  initTimeModule(GMT_OFFSET, DST_OFFSET);
   Serial.println("Time init done.");
 
+  // LAN status endpoint (runs in its own task)
+  initStatusServer(80);
+
   // initialize display
   SPI.begin(TFT_SCLK, TFT_MISO, TFT_MOSI);
   tft.init(170, 320);
   tft.setRotation(3);
-  tft.fillScreen(ST77XX_BLACK);
+#if defined(ARDUINO_ARCH_ESP32) && DISPLAY_DMA
+  // hand the bus to the DMA transport; GFX drawing below is unchanged
+  tft.beginDma(TFT_SCLK, TFT_MOSI);
+#ifdef DISPLAY_DMA_BENCH
+  tft.benchmark(10);
+#endif
+#endif
+  screen.fillScreen(ST77XX_BLACK);
   SCREEN_W = tft.width();
   SCREEN_H = tft.height();
   Serial.printf("Screen W=%d H=%d\n", SCREEN_W, SCREEN_H);
@@ -156,15 +263,15 @@ void setup() {
   //scrollSmallY = (TOP_BAND_H - (int)(8 * scrollSmallTextSize)) / 2; // Commented out for better scrollSmallY calculated below. That way text scroll doesnt scroll 3-4 lines, only 1 using text bounds ||  If you later change the size, this still works.
 
     // compute scrollSmallY more robustly using text bounds
-  tft.setTextSize(scrollSmallTextSize);
-  tft.setTextWrap(false); // ensure no wrapping when we measure
+  screen.setTextSize(scrollSmallTextSize);
+  screen.setTextWrap(false); // ensure no wrapping when we measure
   // measure an approximate character height using "Mg" as sample
   int16_t tbx, tby;
   uint16_t tbw, tbh;
-  tft.getTextBounds("Mg", 0, 0, &tbx, &tby, &tbw, &tbh);
+  screen.getTextBounds("Mg", 0, 0, &tbx, &tby, &tbw, &tbh);
   // center vertically inside the top band
   scrollSmallY = max(0, (TOP_BAND_H - (int)tbh) / 2);
-  scrollSmallX = SCREEN_W; // start from right edge
+  initTicker(SCREEN_W, scrollSmallTextSize, ST77XX_BLACK); // messages start from the right edge
 
 
   // graph area (middle-right): leave left column for stat boxes
@@ -181,106 +288,147 @@ void setup() {
   // clock baseline stays at bottom-left (we keep user-friendly Y offset)
   // (clock drawing will compute cursor Y dynamically)
 
-  // initialize RGB strip (unchanged)
+  // initialize RGB strip; animations run from their own task (LedUtils)
   strip.begin();
+  initLedEngine(LEDS_COUNT, 64);
 
   // initialize weather module (cache 10 minutes)
-  initWeather(OPENWEATHER_KEY, "Groton,CT,US", WEATHER_REFRESH_MS);
+  if (STATION_RELAY_ROLE == RELAY_ROLE_SUBSCRIBER) {
+    initWeatherRelay(RELAY_GATEWAY_HOST, 80, WEATHER_REFRESH_MS);
+  } else {
+    initWeather(OPENWEATHER_KEY, weatherCity, WEATHER_REFRESH_MS);
+    if (STATION_RELAY_ROLE == RELAY_ROLE_GATEWAY) enableWeatherGateway();
+  }
+
+  // rolling observation history (restored from flash if mirrored)
+  initHistory();
+
+  // alert rules are parsed once here
+  initAlerts(ALERT_RULES);
 
   //Maybe add LAT+LON For better and more precise weather
 
 
-  // Seed msgs[1] with current cached weather summary
-  msgs[1] = getWeatherReport();
-  curMsg = msgs[currentMsg];
+  // Seed the ticker: current cached weather summary, then the custom messages
+  tickerWeatherId = tickerPost("weather", getWeatherReport().c_str(), TICKER_PRIO_NORMAL, ST77XX_CYAN);
+  for (const char* m : TICKER_CUSTOM) tickerPost("custom", m, TICKER_PRIO_NORMAL, ST77XX_CYAN);
 
   // Let graph module know where to draw
   setGraphArea(graphX, graphY, graphW, graphH);
 
-  // Try an immediate forecast fetch (non-blocking via tryUpdateWeather or forced)
-  if (tryUpdateWeather(millis())) {
+  // Try an immediate forecast fetch (non-blocking via tryUpdateWeather or forced);
+  // the loop's 10-minute check counts from here
+  lastWeatherCheckMs = millis();
+  if (tryUpdateWeather(lastWeatherCheckMs)) {
     // If fetch occurred, update graph/boxes now from cached forecast
     calculateGraphDataFromForecastRaw(); // implemented in GraphUtils
     calculateLeftBoxDataFromForecastRaw(); // implemented in LeftBoxUtils
-    msgs[1] = getWeatherReport(); // refresh ticker string
+    recordHistoryFromSnapshot(); // one observation per fetch
+    ledUpdateFromSnapshot();     // pick LED animation for current conditions
+    applyWeatherReport();        // refresh ticker string
   } else {
     // If no fetch happened (cache valid), still attempt to populate graph data from previously cached forecast
     calculateGraphDataFromForecastRaw();
     calculateLeftBoxDataFromForecastRaw();
   }
+  if (alertsUpdate(getWeatherSnapshot())) applyAlerts();
+
+  statusPublishSnapshot(); // hand the snapshot + fetch stats to the status server
 
   // initial render: clear UI areas and draw initial static elements
-  tft.fillScreen(ST77XX_BLACK);
+  screen.fillScreen(ST77XX_BLACK);
   // draw top small-band background
-  tft.fillRect(0, 0, SCREEN_W, TOP_BAND_H, ST77XX_BLACK);
+  screen.fillRect(0, 0, SCREEN_W, TOP_BAND_H, ST77XX_BLACK);
   // draw left boxes outline
   drawLeftBoxes(leftBoxX, leftBoxY, leftBoxW, leftBoxH);
   // draw initial graph
   drawGraph(graphIndex);
   // draw initial clock (will be updated in loop)
   // (we rely on the optimized clock drawing helper we used in v4)
+  displayFlush(); // first full frame to the panel
   Serial.println("Setup complete. Entering loop.");
 }
 
 // ----- loop: orchestrate tasks via millis() ----- 
 void loop() {
-  unsigned long now = millis();
-
-  // 1) Weather refresh check (guarded inside tryUpdateWeather)
-  if (now - lastWeatherCheckMs >= WEATHER_REFRESH_MS) {
-    lastWeatherCheckMs = now;
-    bool fetched = tryUpdateWeather(now); // returns true if a network fetch actually performed
+  uint32_t now = millis();
+  uint32_t frameStartUs = micros();
+  bool drew = false; // only passes that drew count towards frame timing
+
+  // 0) Serial console: takes the bytes already received (no allocation, no waiting)
+  //    and runs a command once its line is complete
+  consoleService();
+  ledService();   // a scene change that waited for the LED task's ack
+  netService();   // a Wi-Fi connect started by a fetch (never waited for here)
+
+  // 1) Weather refresh check (guarded inside tryUpdateWeather); a console "fetch" forces one;
+  //    while Wi-Fi comes up for a fetch, it is retried every pass instead of waiting, and a
+  //    relay subscriber takes a multicast snapshot on the pass after it arrives
+  bool forceFetch = consoleTakeFetchRequest();
+  bool linkWait = weatherFetchPending();
+  bool relayArrived = weatherRelayArrived();
+  if (forceFetch || linkWait || relayArrived || now - lastWeatherCheckMs >= WEATHER_REFRESH_MS) {
+    if (!linkWait) lastWeatherCheckMs = now;
+    // returns true if a network fetch actually performed
+    bool fetched = forceFetch ? fetchForecastNow() : tryUpdateWeather(now);
     if (fetched) {
       // update graph and leftboxes from new forecast cache
       calculateGraphDataFromForecastRaw();
       calculateLeftBoxDataFromForecastRaw();
-      // update ticker textual message
-      msgs[1] = getWeatherReport();
-      // optionally force the ticker to restart to show new text immediately:
-      if (currentMsg == 1) scrollSmallX = SCREEN_W;
+      recordHistoryFromSnapshot();
+      ledUpdateFromSnapshot();
+      // update ticker textual message (shown from its next pass)
+      applyWeatherReport();
     }
+    statusPublishSnapshot();
+  }
+
+  // 1b) Nowcast: "now" values follow the wall clock between fetches (once per minute,
+  //     interpolated from the cached snapshot; only changed values are redrawn)
+  uint8_t nowcastChanged = updateNowcast((uint32_t)time(NULL));
+  if (nowcastChanged & NOWCAST_TILES) {
+    calculateLeftBoxDataFromForecastRaw();
+    drawLeftBoxes(leftBoxX, leftBoxY, leftBoxW, leftBoxH);
+    drew = true;
   }
+  if (nowcastChanged & NOWCAST_REPORT) applyWeatherReport();
+
+  // 1c) Alerts: re-checked on a new snapshot and each minute as their windows slide;
+  //     only rules whose field changed are evaluated
+  bool alertsChanged = alertsUpdate(getWeatherSnapshot());
+  if (alertsChanged) applyAlerts();
+  if (nowcastChanged || alertsChanged) statusPublishSnapshot(); // /forecast "derived" follows too
 
   // 2) Graph rotation (every 2 minutes)
   if (now - lastGraphSwitchMs >= GRAPH_SWITCH_MS) {
-    lastGraphSwitchMs = now;
+    // advance by the period so a slow pass does not push every later switch back;
+    // resync if we fell a whole period behind (long fetch)
+    lastGraphSwitchMs += GRAPH_SWITCH_MS;
+    if (now - lastGraphSwitchMs >= GRAPH_SWITCH_MS) lastGraphSwitchMs = now;
+    int fromGraph = graphIndex;
     graphIndex = (graphIndex + 1) % NUM_GRAPHS;
-    // redraw graph & left boxes when graph switches
-    drawGraph(graphIndex);
+    // morph into the next graph (frames follow in 2b); left boxes redraw at once
+    graphBeginTransition(fromGraph, graphIndex, now);
     drawLeftBoxes(leftBoxX, leftBoxY, leftBoxW, leftBoxH);
+    drew = true;
   }
 
+  // 2b) Graph transition frames (~30 fps while a switch morphs; each frame stays
+  //     within GRAPH_ANIM_BUDGET_US and repaints only the bands whose line moved)
+  if (graphTransitionActive() && graphTransitionFrame(now)) drew = true;
+
     // 3) Small top ticker update (runs frequently; use smallScrollInterval)
   if (now - lastSmallScrollMs >= smallScrollInterval) {
     lastSmallScrollMs = now;
 
-    // Only clear the top band area (reduce flicker)
-    tft.fillRect(0, 0, SCREEN_W, TOP_BAND_H, ST77XX_BLACK);
-
-    // Draw small ticker text at configured small size
-    tft.setTextSize(scrollSmallTextSize);
-    tft.setTextWrap(false);                 // IMPORTANT: disable wrapping so text stays on a single line
-    tft.setTextColor(ST77XX_CYAN, ST77XX_BLACK); // foreground, background (helps remove artifacts)
-
-    // Use current msgs[1] (weather) as the ticker
-    tft.setCursor(scrollSmallX, scrollSmallY);
-    tft.print(msgs[1]);
-
-    // Advance X and wrap when off-screen: measure pixel width of current message
-    int16_t bx, by; uint16_t bw, bh;
-    tft.getTextBounds(msgs[1].c_str(), 0, 0, &bx, &by, &bw, &bh);
-    scrollSmallX -= scrollSmallSpeed;
-    if (scrollSmallX < - (int)bw) {
-      scrollSmallX = SCREEN_W;
-    }
-
-    // Restore main text size (if other code expects it)
-    tft.setTextSize(textSizeScale);
+    // Blit the visible part of the current message's pre-rendered strip (only its text
+    // rows are cleared) and advance; the next queued message follows once it has left
+    if (tickerFrame(scrollSmallY, scrollSmallSpeed, now)) drew = true;
   }
 
 
-  // 4) Optionally: main marquee & LED crossfade handling (unchanged from v4)
-  //  - reuse your existing RGB crossfade code here
+  // 4) Optionally: main marquee (unchanged from v4)
+  //  - LED animations are played by the LedUtils task, nothing to do here
   //  - reuse your main marquee code if you still want a large scrolling message
 
   // 5) Clock: update efficiently (only when time string changes or at interval)
@@ -292,9 +440,14 @@ void loop() {
       // Implement a helper function in UIUtils or in main (you already have this in v4)
       drawClockBottom(nowTime); // expected helper - see comment below
       prevClockText = nowTime;
+      drew = true;
     }
   }
 
+  // push what this pass composed (only the dirty strips of the framebuffer)
+  displayFlush();
+  if (drew) statusNoteFrame(micros() - frameStartUs);
+
   // 6) Yield / short delay if desired (avoid busy looping)
   delay(1);
 }
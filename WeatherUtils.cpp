@@ -3,14 +3,30 @@
 #include <HTTPClient.h>
 #include <ArduinoJson.h>
 #include <time.h> // for getLocalTime()
+#include <limits.h>
+#include "RelayUtils.h"
+#include "NetUtils.h"
 
 // Internal cached state
 static String s_apiKey = "";
 static String s_city = "";
 static unsigned long s_cacheMs = 600000; // default 10 minutes
-static unsigned long s_lastFetch = 0;
+static uint32_t s_lastFetch = 0;                      // millis() of the last snapshot
+static bool s_haveFetch = false;                      // s_lastFetch is valid (0 is a valid millis())
 static String s_cachedReport = "Weather: unknown";    // short single-line summary for ticker
 static String s_cachedForecastJson = "";              // raw forecast JSON payload (for GraphUtils)
+static WeatherSnapshot s_snapshot = {};               // parsed once per fetch
+static WeatherFetchStats s_fetchStats = {};
+static uint32_t s_seq = 0;                            // local snapshot counter
+static bool s_nowcastDirty = true;                    // new snapshot: nowcast rebuilds its segments
+
+// Where forecasts come from (OpenWeather directly, or a relay gateway)
+static bool s_useRelay = false;
+static bool s_isGateway = false;
+static String s_relayHost = "";
+static uint16_t s_relayPort = 80;
+static bool s_relayUnchanged = false;  // last relay fetch found the snapshot we hold
+static bool s_linkWait = false;        // fetch deferred while Wi-Fi connects in the background
 
 // Small helper to trim and limit length
 static String shorten(const String &src, size_t maxLen = 120) {
@@ -18,25 +34,158 @@ static String shorten(const String &src, size_t maxLen = 120) {
   return src.substring(0, maxLen - 3) + "...";
 }
 
+// City query as it goes into the URL: spaces are likely ("New London,CT,US") and must be
+// escaped, whether the city was compiled in, loaded from NVS or typed at the console
+static String cityQueryParam(const char *cityQuery) {
+  String city;
+  for (const char *p = cityQuery ? cityQuery : ""; *p; ++p) {
+    if (*p == ' ') city += "%20";
+    else city += *p;
+  }
+  return city;
+}
+
 // Initialize weather subsystem
 void initWeather(const char* apiKey, const char* cityQuery, unsigned long cacheMillis) {
   s_apiKey = String(apiKey);
-  s_city = String(cityQuery);
+  s_city = cityQueryParam(cityQuery);
   s_cacheMs = cacheMillis;
-  s_lastFetch = 0; // force fetch on first tryUpdateWeather
+  s_haveFetch = false; // force fetch on first tryUpdateWeather
   s_cachedReport = "Weather: loading...";
   s_cachedForecastJson = "";
+  s_snapshot.valid = false;
+  s_snapshot.count = 0;
+}
+
+// Initialize as a relay subscriber: no API key, snapshots come from a gateway station
+void initWeatherRelay(const char* gatewayHost, uint16_t gatewayPort, unsigned long cacheMillis) {
+  initWeather("", "", cacheMillis);
+  s_useRelay = true;
+  s_relayHost = String(gatewayHost ? gatewayHost : "");
+  s_relayPort = gatewayPort;
+  initRelaySubscriber();
+}
+
+// Gateway: every successful OpenWeather fetch is also published to the LAN
+void enableWeatherGateway() {
+  s_isGateway = true;
+  initRelayGateway();
+}
+
+void setWeatherCity(const char* cityQuery) {
+  String city = cityQueryParam(cityQuery);
+  if (s_city == city) return;
+  s_city = city;
+  s_haveFetch = false; // the cached forecast is for the old city
+}
+
+void setWeatherCacheMs(unsigned long cacheMillis) {
+  s_cacheMs = cacheMillis;
+}
+
+// -------------------------- derived metrics --------------------------
+// Linear interpolation of one slot field at UTC time t (clamped to the forecast range;
+// a NAN on one side takes the other side's value)
+static float valueAt(const WeatherSnapshot &snap, uint32_t t, float ForecastSlot::*field) {
+  if (snap.count == 0) return NAN;
+  if (t <= snap.slots[0].dt) return snap.slots[0].*field;
+  for (int i = 0; i + 1 < snap.count; ++i) {
+    const ForecastSlot &a = snap.slots[i];
+    const ForecastSlot &b = snap.slots[i + 1];
+    if (t >= b.dt) continue;
+    float va = a.*field, vb = b.*field;
+    if (isnan(va)) return vb;
+    if (isnan(vb) || b.dt == a.dt) return va;
+    return va + (vb - va) * (float)(t - a.dt) / (float)(b.dt - a.dt);
+  }
+  return snap.slots[snap.count - 1].*field;
+}
+
+static int8_t humidityAt(const WeatherSnapshot &snap, uint32_t t) {
+  // nearest slot (humidity moves slowly and is an integer anyway)
+  int best = 0;
+  for (int i = 1; i < snap.count; ++i) {
+    long d = labs((long)snap.slots[i].dt - (long)t);
+    if (d < labs((long)snap.slots[best].dt - (long)t)) best = i;
+  }
+  return snap.count ? snap.slots[best].humidity : -1;
+}
+
+// NWS wind chill / Rothfusz heat index (°F, mph, %)
+static float feelsLikeF(float tempF, float windMph, int humidity) {
+  if (isnan(tempF)) return NAN;
+  if (tempF <= 50.0f && !isnan(windMph) && windMph >= 3.0f) {
+    float v = powf(windMph, 0.16f);
+    return 35.74f + 0.6215f * tempF - 35.75f * v + 0.4275f * tempF * v;
+  }
+  if (tempF >= 80.0f && humidity >= 0) {
+    float T = tempF, R = (float)humidity;
+    return -42.379f + 2.04901523f * T + 10.14333127f * R - 0.22475541f * T * R
+           - 0.00683783f * T * T - 0.05481717f * R * R + 0.00122874f * T * T * R
+           + 0.00085282f * T * R * R - 0.00000199f * T * T * R * R;
+  }
+  return tempF;
+}
+
+void computeDerivedMetrics(WeatherSnapshot &snap, uint32_t nowEpoch) {
+  WeatherDerived &d = snap.derived;
+  memset(&d, 0, sizeof(d));
+  d.nowTemp = d.nowWind = d.nowPop = d.feelsLike = d.trend3h = NAN;
+  d.todayHi = d.todayLo = d.nextRainPop = NAN;
+  d.nowHumidity = -1;
+  if (!snap.valid || snap.count == 0) return;
+
+  if (nowEpoch == 0) nowEpoch = snap.slots[0].dt; // no NTP yet: treat slot 0 as now
+  d.computedAt = nowEpoch;
+  d.nowTemp = valueAt(snap, nowEpoch, &ForecastSlot::temp);
+  d.nowWind = valueAt(snap, nowEpoch, &ForecastSlot::wind);
+  d.nowPop = valueAt(snap, nowEpoch, &ForecastSlot::pop);
+  d.nowHumidity = humidityAt(snap, nowEpoch);
+  d.feelsLike = feelsLikeF(d.nowTemp, d.nowWind, d.nowHumidity);
+  float later = valueAt(snap, nowEpoch + 3 * 3600UL, &ForecastSlot::temp);
+  if (!isnan(d.nowTemp) && !isnan(later)) d.trend3h = later - d.nowTemp;
+
+  // end of the city-local day containing now
+  long localNow = (long)nowEpoch + snap.tzOffset;
+  uint32_t dayEnd = (uint32_t)(localNow - (localNow % 86400L) + 86400L - snap.tzOffset);
+
+  if (!isnan(d.nowTemp)) {
+    d.todayHi = d.todayLo = d.nowTemp;
+    d.todayHiAt = d.todayLoAt = nowEpoch;
+  }
+  for (int i = 0; i < snap.count; ++i) {
+    const ForecastSlot &s = snap.slots[i];
+    if (s.dt < nowEpoch) continue;
+    if (s.dt < dayEnd && !isnan(s.temp)) {
+      if (isnan(d.todayHi) || s.temp > d.todayHi) { d.todayHi = s.temp; d.todayHiAt = s.dt; }
+      if (isnan(d.todayLo) || s.temp < d.todayLo) { d.todayLo = s.temp; d.todayLoAt = s.dt; }
+    }
+    if (d.nextRainAt == 0 && !isnan(s.pop) && s.pop >= DERIVED_RAIN_POP) {
+      d.nextRainAt = s.dt;
+      d.nextRainPop = s.pop;
+    }
+  }
+  // rain already likely in the current 3h window
+  if (!isnan(d.nowPop) && d.nowPop >= DERIVED_RAIN_POP) {
+    d.nextRainAt = nowEpoch;
+    d.nextRainPop = d.nowPop;
+  }
+  d.valid = true;
 }
 
-// Build a short summary from forecast JSON (use first forecast entry as "now-ish")
-static String buildReportFromForecastJson(JsonDocument &doc) {
-  // doc structure: { "city": { "name": "...", ...}, "list": [ { "main": {"temp":...}, "wind":{"speed":...}, "weather":[{"description": "..."}], ... }, ... ] }
-  const char* cityName = doc["city"]["name"] | "";
-  JsonVariant first = doc["list"][0];
-  float temp = first["main"]["temp"] | NAN;
-  int humidity = first["main"]["humidity"] | -1;
-  float wind = first["wind"]["speed"] | NAN;
-  const char* desc = first["weather"][0]["description"] | "";
+static uint32_t epochNow() {
+  time_t now_t = time(NULL);
+  return (now_t > 1600000000) ? (uint32_t)now_t : 0; // 0 until NTP has synced
+}
+
+// Build a short summary from the snapshot's derived "now" values
+static String buildReportFromSnapshot(const WeatherSnapshot &snap) {
+  const char* cityName = snap.city;
+  const WeatherDerived &d = snap.derived;
+  float temp = d.nowTemp;
+  int humidity = d.nowHumidity;
+  float wind = d.nowWind;
+  const char* desc = snap.desc;
 
   char buf[160];
   if (isnan(temp)) {
@@ -51,25 +200,147 @@ static String buildReportFromForecastJson(JsonDocument &doc) {
       snprintf(buf, sizeof(buf), "%s %d°F %s Wind %dmph", cityName, t, desc, w);
     }
   }
+
+  // Append hi/lo and the next rain window when known
+  size_t len = strlen(buf);
+  if (!isnan(d.todayHi) && len < sizeof(buf)) {
+    len += snprintf(buf + len, sizeof(buf) - len, " H %d L %d", (int)round(d.todayHi), (int)round(d.todayLo));
+  }
+  if (!isnan(d.feelsLike) && !isnan(temp) && fabsf(d.feelsLike - temp) >= 3.0f && len < sizeof(buf)) {
+    len += snprintf(buf + len, sizeof(buf) - len, " Feels %d°F", (int)round(d.feelsLike));
+  }
+  if (d.nextRainAt != 0 && len < sizeof(buf)) {
+    if (d.nextRainAt == d.computedAt) {
+      snprintf(buf + len, sizeof(buf) - len, " Rain now %d%%", (int)round(d.nextRainPop * 100.0f));
+    } else {
+      time_t local = (time_t)d.nextRainAt + snap.tzOffset;
+      struct tm tmr;
+      gmtime_r(&local, &tmr); // city wall-clock
+      int h12 = tmr.tm_hour % 12;
+      if (h12 == 0) h12 = 12;
+      snprintf(buf + len, sizeof(buf) - len, " Rain %d%s %d%%", h12, tmr.tm_hour < 12 ? "AM" : "PM",
+               (int)round(d.nextRainPop * 100.0f));
+    }
+  }
   return String(buf);
 }
 
+// Copy the fields the UI needs out of the parsed document into a fixed-size snapshot
+static void fillSnapshotFromForecastJson(JsonDocument &doc, WeatherSnapshot &snap) {
+  snap.valid = false;
+  snap.count = 0;
+  snap.tzOffset = doc["city"]["timezone"] | 0L;
+  strlcpy(snap.city, doc["city"]["name"] | "", sizeof(snap.city));
+  strlcpy(snap.desc, doc["list"][0]["weather"][0]["description"] | "", sizeof(snap.desc));
+
+  snap.fetchedAt = epochNow();
+
+  JsonArray list = doc["list"].as<JsonArray>();
+  for (JsonObject item : list) {
+    if (snap.count >= SNAPSHOT_MAX_SLOTS) break;
+    ForecastSlot &slot = snap.slots[snap.count++];
+    slot.dt = item["dt"] | 0UL;
+    slot.temp = item["main"]["temp"] | NAN;
+    slot.wind = item["wind"]["speed"] | NAN;
+    slot.pop = item["pop"] | NAN;
+    slot.humidity = (int8_t)(item["main"]["humidity"] | -1);
+  }
+  snap.valid = (snap.count > 0);
+  computeDerivedMetrics(snap, snap.fetchedAt);
+}
+
 /*
   fetchForecastNow()
   - Performs HTTP GET to OpenWeather /data/2.5/forecast (3-hour)
   - On success stores:
       s_cachedForecastJson = raw payload
       s_cachedReport = short summary (first list[] item)
+      s_snapshot = parsed slots (see getWeatherSnapshot())
       s_lastFetch = millis()
     and prints a human-readable "Weather API called at: HH:MM:SS AM/PM" to Serial.
   - Returns true on successful fetch+parse+cache, false on error.
+  - Never waits for Wi-Fi: with the link down it starts a background connect and
+    returns false with weatherFetchPending() set; the attempt happens (and counts) on
+    the first call after the connect has ended.
 */
+static bool fetchFromOpenWeather();
+static bool fetchFromRelay();
+
 bool fetchForecastNow() {
-  // Only attempt if WiFi connected
-  if (WiFi.status() != WL_CONNECTED) {
+  if (s_linkWait && netConnecting()) return false;   // still associating: next pass
+  bool retry = s_linkWait;
+  s_linkWait = false;
+  // wake the radio for the fetch (NetUtils idles it again afterwards); a connect that
+  // has ended without a link is not restarted, this attempt fails instead
+  bool up = false;
+  if (!retry || netConnected()) {
+    up = netAcquireNoWait("weather");
+    if (!up) {
+      netRelease("weather");
+      s_linkWait = netConnecting();
+      if (s_linkWait) return false;
+    }
+  }
+
+  unsigned long start = millis();
+  s_fetchStats.attempts++;
+  s_relayUnchanged = false;
+  bool ok = false;
+  if (up) {
+    ok = s_useRelay ? fetchFromRelay() : fetchFromOpenWeather();
+    netRelease("weather");
+  } else {
     Serial.println("fetchForecastNow(): WiFi not connected - skipping fetch");
+  }
+  s_fetchStats.lastLatencyMs = millis() - start;
+  if (ok) {
+    s_fetchStats.lastSuccessMs = s_lastFetch;
+    s_fetchStats.haveSuccess = true;
+  } else if (!s_relayUnchanged) {
+    s_fetchStats.failures++;
+  }
+  return ok;
+}
+
+static void loadRelaySnapshot(const WeatherSnapshot &incoming) {
+  s_snapshot = incoming;
+  computeDerivedMetrics(s_snapshot, epochNow()); // derived facts are not on the wire
+  s_cachedReport = shorten(buildReportFromSnapshot(s_snapshot), 120);
+  s_cachedForecastJson = ""; // relay carries no raw JSON
+  s_nowcastDirty = true;
+  s_lastFetch = millis();
+  s_haveFetch = true;
+  s_fetchStats.lastSuccessMs = s_lastFetch; // multicast snapshots count, not just fetches
+  s_fetchStats.haveSuccess = true;
+  Serial.printf("Weather relay snapshot loaded: seq=%lu slots=%d\n",
+                (unsigned long)s_snapshot.seq, s_snapshot.count);
+}
+
+// The relay resends the gateway's snapshot: the one we already hold is not a new fetch
+static bool isCurrentSnapshot(const WeatherSnapshot &incoming) {
+  return s_snapshot.valid && incoming.seq == s_snapshot.seq && incoming.fetchedAt == s_snapshot.fetchedAt;
+}
+
+// Relay backend: newest multicast snapshot, else ask the gateway over HTTP. Returns true
+// only for a new snapshot; an unchanged one just confirms the cache (s_relayUnchanged).
+static bool fetchFromRelay() {
+  static WeatherSnapshot incoming;
+  bool got = relayTakeLatest(incoming);
+  if (!got && s_relayHost.length() > 0) got = relayFetchHttp(s_relayHost.c_str(), s_relayPort, incoming);
+  if (!got || !incoming.valid) {
+    Serial.println("fetchForecastNow(): no relay snapshot available");
+    return false;
+  }
+  if (isCurrentSnapshot(incoming)) {
+    s_relayUnchanged = true;
+    s_lastFetch = millis();
     return false;
   }
+  loadRelaySnapshot(incoming);
+  return true;
+}
+
+static bool fetchFromOpenWeather() {
 
   HTTPClient http;
   String url = "http://api.openweathermap.org/data/2.5/forecast?q=" + s_city +
@@ -101,14 +372,15 @@ bool fetchForecastNow() {
     return false;
   }
 
-  // Build short one-line summary from parsed JSON (first item)
-  String report = buildReportFromForecastJson(doc);
-  report = shorten(report, 120);
-
-  // Cache raw payload and the summary
+  // Cache raw payload, the parsed snapshot and the short summary (first item)
   s_cachedForecastJson = payload;
-  s_cachedReport = report;
+  fillSnapshotFromForecastJson(doc, s_snapshot);
+  s_snapshot.seq = ++s_seq;
+  s_cachedReport = shorten(buildReportFromSnapshot(s_snapshot), 120);
+  s_nowcastDirty = true;
   s_lastFetch = millis();
+  s_haveFetch = true;
+  if (s_isGateway) relayPublish(s_snapshot);
 
   // Print human-readable timestamp for the successful API call
   struct tm timeinfo;
@@ -119,7 +391,7 @@ bool fetchForecastNow() {
     Serial.println(timestr);
   } else {
     Serial.print("Weather API called (millis): ");
-    Serial.println(s_lastFetch);
+    Serial.println((unsigned long)s_lastFetch);
   }
 
   return true;
@@ -135,13 +407,191 @@ String getCachedForecastRaw() {
   return s_cachedForecastJson;
 }
 
+// Return the forecast parsed at the last successful fetch
+const WeatherSnapshot &getWeatherSnapshot() {
+  return s_snapshot;
+}
+
+const WeatherFetchStats &getWeatherFetchStats() {
+  return s_fetchStats;
+}
+
+// -------------------------- nowcast --------------------------
+// One linear piece of a channel: value(t) = v0 + slope * (t - start) for start <= t < end.
+// Built with the same clamping / NAN rules as valueAt() and humidityAt().
+struct NowSegment {
+  uint32_t start, end;
+  float    v0, slope;
+};
+
+static NowSegment s_segTemp, s_segWind, s_segPop, s_segHum;
+static NowSegment s_segAhead;            // temp at t + 3h (trend3h)
+static uint32_t s_nowcastMinute = 0;
+
+// Rest-of-day facts over the slots at or after now; fixed until a slot drops out or midnight
+static uint32_t s_restFrom = 0, s_restUntil = 0;
+static float    s_restHi, s_restLo, s_restRainPop;
+static uint32_t s_restHiAt, s_restLoAt, s_restRainAt;
+
+static NowSegment segmentAt(const WeatherSnapshot &snap, uint32_t t, float ForecastSlot::*field) {
+  NowSegment seg = { 0, UINT32_MAX, NAN, 0.0f };
+  if (snap.count == 0) return seg;
+  if (t < snap.slots[0].dt) {
+    seg.end = snap.slots[0].dt;
+    seg.v0 = snap.slots[0].*field;
+    return seg;
+  }
+  for (int i = 0; i + 1 < snap.count; ++i) {
+    const ForecastSlot &a = snap.slots[i];
+    const ForecastSlot &b = snap.slots[i + 1];
+    if (t >= b.dt) continue;
+    seg.start = a.dt;
+    seg.end = b.dt;
+    float va = a.*field, vb = b.*field;
+    seg.v0 = isnan(va) ? vb : va;
+    if (!isnan(va) && !isnan(vb)) seg.slope = (vb - va) / (float)(b.dt - a.dt);
+    return seg;
+  }
+  seg.start = snap.slots[snap.count - 1].dt;
+  seg.v0 = snap.slots[snap.count - 1].*field;
+  return seg;
+}
+
+// Nearest slot wins; on a tie the earlier one (as humidityAt())
+static NowSegment humiditySegmentAt(const WeatherSnapshot &snap, uint32_t t) {
+  NowSegment seg = { 0, UINT32_MAX, -1.0f, 0.0f };
+  if (snap.count == 0) return seg;
+  int best = 0;
+  while (best + 1 < snap.count &&
+         (uint32_t)(((uint64_t)snap.slots[best].dt + snap.slots[best + 1].dt) / 2) < t) ++best;
+  if (best > 0) seg.start = (uint32_t)(((uint64_t)snap.slots[best - 1].dt + snap.slots[best].dt) / 2) + 1;
+  if (best + 1 < snap.count) seg.end = (uint32_t)(((uint64_t)snap.slots[best].dt + snap.slots[best + 1].dt) / 2) + 1;
+  seg.v0 = snap.slots[best].humidity;
+  return seg;
+}
+
+static float segmentValue(const NowSegment &seg, uint32_t t) {
+  return seg.v0 + seg.slope * (float)(t - seg.start);
+}
+
+static bool segmentCovers(const NowSegment &seg, uint32_t t) {
+  return t >= seg.start && t < seg.end;
+}
+
+static void computeRestOfDay(const WeatherSnapshot &snap, uint32_t t) {
+  long localNow = (long)t + snap.tzOffset;
+  uint32_t dayEnd = (uint32_t)(localNow - (localNow % 86400L) + 86400L - snap.tzOffset);
+  s_restHi = s_restLo = s_restRainPop = NAN;
+  s_restHiAt = s_restLoAt = s_restRainAt = 0;
+  s_restFrom = t;
+  s_restUntil = dayEnd;
+  for (int i = 0; i < snap.count; ++i) {
+    const ForecastSlot &s = snap.slots[i];
+    if (s.dt < t) continue;
+    if (s.dt + 1 < s_restUntil) s_restUntil = s.dt + 1; // this slot drops out after its time
+    if (s.dt < dayEnd && !isnan(s.temp)) {
+      if (isnan(s_restHi) || s.temp > s_restHi) { s_restHi = s.temp; s_restHiAt = s.dt; }
+      if (isnan(s_restLo) || s.temp < s_restLo) { s_restLo = s.temp; s_restLoAt = s.dt; }
+    }
+    if (s_restRainAt == 0 && !isnan(s.pop) && s.pop >= DERIVED_RAIN_POP) {
+      s_restRainAt = s.dt;
+      s_restRainPop = s.pop;
+    }
+  }
+}
+
+uint8_t updateNowcast(uint32_t nowEpoch) {
+  if (!s_snapshot.valid || s_snapshot.count == 0 || nowEpoch < 1600000000UL) return 0;
+  uint32_t minute = nowEpoch / 60;
+  if (!s_nowcastDirty && minute == s_nowcastMinute) return 0;
+  uint32_t t = minute * 60;               // evaluate at the start of the wall-clock minute
+  bool dirty = s_nowcastDirty;
+  s_nowcastDirty = false;
+  s_nowcastMinute = minute;
+
+  // Re-bracket only the channels whose segment ran out
+  const WeatherSnapshot &snap = s_snapshot;
+  if (dirty || !segmentCovers(s_segTemp, t)) s_segTemp = segmentAt(snap, t, &ForecastSlot::temp);
+  if (dirty || !segmentCovers(s_segWind, t)) s_segWind = segmentAt(snap, t, &ForecastSlot::wind);
+  if (dirty || !segmentCovers(s_segPop, t)) s_segPop = segmentAt(snap, t, &ForecastSlot::pop);
+  if (dirty || !segmentCovers(s_segHum, t)) s_segHum = humiditySegmentAt(snap, t);
+  uint32_t ahead = t + 3 * 3600UL;
+  if (dirty || !segmentCovers(s_segAhead, ahead)) s_segAhead = segmentAt(snap, ahead, &ForecastSlot::temp);
+  if (dirty || t < s_restFrom || t >= s_restUntil) computeRestOfDay(snap, t);
+
+  WeatherDerived &d = s_snapshot.derived;
+  int prevTemp = isnan(d.nowTemp) ? INT_MIN : (int)round(d.nowTemp);
+  int prevWind = isnan(d.nowWind) ? INT_MIN : (int)round(d.nowWind);
+  int prevHum = d.nowHumidity;
+
+  d.computedAt = t;
+  d.nowTemp = segmentValue(s_segTemp, t);
+  d.nowWind = segmentValue(s_segWind, t);
+  d.nowPop = segmentValue(s_segPop, t);
+  d.nowHumidity = (int8_t)s_segHum.v0;
+  d.feelsLike = feelsLikeF(d.nowTemp, d.nowWind, d.nowHumidity);
+  float later = segmentValue(s_segAhead, ahead);
+  d.trend3h = (!isnan(d.nowTemp) && !isnan(later)) ? later - d.nowTemp : NAN;
+
+  // hi/lo: the interpolated now competes with the remaining slots of the day
+  d.todayHi = d.todayLo = d.nowTemp;
+  d.todayHiAt = d.todayLoAt = isnan(d.nowTemp) ? 0 : t;
+  if (!isnan(s_restHi) && (isnan(d.todayHi) || s_restHi > d.todayHi)) { d.todayHi = s_restHi; d.todayHiAt = s_restHiAt; }
+  if (!isnan(s_restLo) && (isnan(d.todayLo) || s_restLo < d.todayLo)) { d.todayLo = s_restLo; d.todayLoAt = s_restLoAt; }
+  d.nextRainAt = s_restRainAt;
+  d.nextRainPop = s_restRainPop;
+  if (!isnan(d.nowPop) && d.nowPop >= DERIVED_RAIN_POP) {
+    d.nextRainAt = t;
+    d.nextRainPop = d.nowPop;
+  }
+  d.valid = true;
+
+  uint8_t changed = 0;
+  int curTemp = isnan(d.nowTemp) ? INT_MIN : (int)round(d.nowTemp);
+  int curWind = isnan(d.nowWind) ? INT_MIN : (int)round(d.nowWind);
+  // a new snapshot was derived at ingest, so "prev" already holds its values: the boxes
+  // the fetch rebuilt still have to be drawn
+  if (dirty || curTemp != prevTemp || curWind != prevWind || d.nowHumidity != prevHum) changed |= NOWCAST_TILES;
+  String report = shorten(buildReportFromSnapshot(s_snapshot), 120);
+  if (report != s_cachedReport) {
+    s_cachedReport = report;
+    changed |= NOWCAST_REPORT;
+  }
+  return changed;
+}
+
+bool weatherFetchPending() {
+  return s_linkWait;
+}
+
+bool weatherRelayArrived() {
+  return s_useRelay && relayHasLatest();
+}
+
 // Try to update weather if cache expired. Returns true if a real network fetch was performed.
 bool tryUpdateWeather(unsigned long nowMillis) {
-  if (s_lastFetch == 0 || (nowMillis - s_lastFetch) > s_cacheMs) {
+  // Relay subscriber: take a multicast snapshot as soon as it arrives; loop() calls in on
+  // the next pass when weatherRelayArrived() says one is waiting (no network I/O here)
+  if (s_useRelay) {
+    static WeatherSnapshot incoming;
+    if (relayTakeLatest(incoming) && incoming.valid && !isCurrentSnapshot(incoming)) {
+      loadRelaySnapshot(incoming);
+      return true;
+    }
+    // the gateway is still multicasting the snapshot we hold: no HTTP fallback needed
+    if (!s_linkWait && s_haveFetch && relayHeardWithin(s_cacheMs)) return false;
+  }
+  // elapsed in 32 bits, as millis() on the ESP32, so the check survives the 49.7-day wrap
+  if (s_linkWait || !s_haveFetch || (uint32_t)(nowMillis - s_lastFetch) >= s_cacheMs) {
     // fetch and update cache
     bool ok = fetchForecastNow();
-    if (!ok) {
+    if (s_linkWait) return false; // Wi-Fi still connecting: the loop calls again next pass
+    if (!ok && !s_relayUnchanged) {
       Serial.println("tryUpdateWeather(): fetch failed - keeping previous cache");
+    } else {
+      // cadence follows the caller's clock, not the end of the fetch: a caller checking
+      // every cacheMillis would otherwise find it "not due yet" and refresh every other time
+      s_lastFetch = (uint32_t)nowMillis;
     }
     return ok;
   }
@@ -11,12 +11,98 @@
     - tryUpdateWeather(nowMillis) -> returns true if a network fetch occurred
     - fetchForecastNow() -> forces a forecast fetch now (returns true on success)
     - getCachedForecastRaw() -> returns the raw JSON payload (empty if none)
+    - getWeatherSnapshot() -> forecast slots parsed once at fetch time (no JSON needed),
+      plus snap.derived: facts computed once per new snapshot (hi/lo, next rain, ...)
+    - updateNowcast(nowEpoch) -> moves snap.derived "now" values to the current minute
+      between fetches (cheap: one linear segment per channel)
+    - initWeatherRelay(...) -> take snapshots from a relay gateway instead (RelayUtils)
+    - enableWeatherGateway() -> publish each OpenWeather snapshot to relay subscribers
 */
 
+// One 3-hour forecast slot, as parsed from list[] at fetch time
+struct ForecastSlot {
+  uint32_t dt;        // UTC epoch seconds
+  float    temp;      // °F (NAN if missing)
+  float    wind;      // mph (NAN if missing)
+  float    pop;       // precipitation probability 0..1 (NAN if missing)
+  int8_t   humidity;  // % (-1 if missing)
+};
+
+const int SNAPSHOT_MAX_SLOTS = 40; // free forecast API returns 5 days x 8 slots
+
+const float DERIVED_RAIN_POP = 0.30f; // pop at which a slot counts as "rain likely"
+
+// Derived once when a snapshot arrives (OpenWeather or relay) so readers never rescan
+// slots. "now" is the ingest time; values are NAN (or 0 for times) when unknown.
+struct WeatherDerived {
+  bool     valid;
+  uint32_t computedAt;    // UTC epoch used as "now"
+  float    nowTemp;       // °F, interpolated between the slots around computedAt
+  float    nowWind;       // mph
+  float    nowPop;        // 0..1
+  int8_t   nowHumidity;   // % (-1 if missing)
+  float    feelsLike;     // °F: NWS wind chill (<=50F) / heat index (>=80F), else nowTemp
+  float    trend3h;       // °F change from now to now+3h
+  float    todayHi;       // °F over the rest of the city-local day (incl. now)
+  float    todayLo;
+  uint32_t todayHiAt;     // UTC epoch of the hi / lo (computedAt if it is "now")
+  uint32_t todayLoAt;
+  uint32_t nextRainAt;    // first slot at or after now with pop >= DERIVED_RAIN_POP (0 = none)
+  float    nextRainPop;
+};
+
+// Parsed forecast kept alongside the raw JSON
+struct WeatherSnapshot {
+  bool     valid;
+  uint32_t seq;                     // increments with every new forecast (kept across relays)
+  uint32_t fetchedAt;               // UTC epoch of the fetch (0 if NTP was not available)
+  int32_t  tzOffset;                // city timezone offset in seconds (city.timezone)
+  char     city[32];
+  char     desc[32];                // weather[0].description of slot 0
+  uint8_t  count;                   // number of valid entries in slots[]
+  ForecastSlot slots[SNAPSHOT_MAX_SLOTS];
+  WeatherDerived derived;           // see computeDerivedMetrics()
+};
+
 void initWeather(const char* apiKey, const char* cityQuery, unsigned long cacheMillis);
+// Relay source: snapshots arrive by multicast; gatewayHost (optional, "" = none) is
+// polled over HTTP when nothing was received
+void initWeatherRelay(const char* gatewayHost, uint16_t gatewayPort, unsigned long cacheMillis);
+void enableWeatherGateway();
+// Runtime changes (serial console): a new city drops the cached forecast, so the next
+// tryUpdateWeather() fetches; a new cache period applies from the next check
+void setWeatherCity(const char* cityQuery);
+void setWeatherCacheMs(unsigned long cacheMillis);
 String getWeatherReport();
 bool tryUpdateWeather(unsigned long nowMillis);
 bool fetchForecastNow();                 // force fetch now (uses HTTP)
+// A fetch is waiting for Wi-Fi to come up: call tryUpdateWeather() on every loop() pass
+bool weatherFetchPending();
+// Relay subscriber: a multicast snapshot is waiting to be taken by tryUpdateWeather()
+bool weatherRelayArrived();
 String getCachedForecastRaw();           // returns raw cached JSON payload (may be "")
+const WeatherSnapshot &getWeatherSnapshot(); // parsed forecast (check .valid)
+
+// Fills snap.derived for the given UTC "now" (called at ingest for every new snapshot)
+void computeDerivedMetrics(WeatherSnapshot &snap, uint32_t nowEpoch);
+
+// Nowcast: re-evaluates the cached snapshot's derived values at the current wall-clock
+// minute (pass time(NULL); does nothing before NTP or twice in the same minute). Each
+// channel keeps the forecast segment it is on and is rebuilt only at slot boundaries
+// and midnight. Returns which displayed values changed (NOWCAST_TILES always, on the
+// first call after a new snapshot); the ticker report is rebuilt when NOWCAST_REPORT is set.
+const uint8_t NOWCAST_TILES  = 0x01;  // rounded temp / wind / humidity (left boxes)
+const uint8_t NOWCAST_REPORT = 0x02;  // getWeatherReport() text
+uint8_t updateNowcast(uint32_t nowEpoch);
+
+// Fetch bookkeeping (for the status endpoint)
+struct WeatherFetchStats {
+  uint32_t attempts;
+  uint32_t failures;
+  uint32_t lastLatencyMs;   // duration of the last attempt (HTTP + parse)
+  uint32_t lastSuccessMs;   // millis() of the last snapshot taken (fetch or relay multicast)
+  bool     haveSuccess;     // lastSuccessMs is valid (0 is a valid millis())
+};
+const WeatherFetchStats &getWeatherFetchStats();
 
 #endif // WEATHERUTILS_H
@@ -0,0 +1,119 @@
+#ifndef HOST_ADAFRUIT_ST7789_H
+#define HOST_ADAFRUIT_ST7789_H
+
+/*
+  MockST7789 - headless stand-in for Adafruit_ST7789 (host builds only)
+
+  The class keeps the Adafruit_ST7789 name so the sketch modules, which declare
+  `extern Adafruit_ST7789 tft;`, link against it unchanged. It derives from the real
+  Adafruit_GFX, so text, lines and circles are broken down into exactly the same
+  primitive calls as on the device.
+
+  Every primitive is accounted the way Adafruit_SPITFT puts it on the wire:
+    - one transaction per outermost startWrite()/endWrite() pair
+    - one address window per setAddrWindow() = CASET(1+4) + RASET(1+4) + RAMWR(1) = 11 bytes
+    - 2 bytes per RGB565 pixel pushed
+  Pixels land in an in-memory RGB565 framebuffer that can be written out as PNG.
+
+  Typical use from a host program:
+    tft.setFrameByteBudget(20000);
+    tft.beginFrame("drawClockBottom");
+    drawClockBottom("09:25:00 AM");
+    if (!tft.endFrame().withinBudget) return 1;    // fail the run
+    if (!tft.matchesGolden("golden/clock.png")) return 1;
+  host/FrameGolden.cpp does this for every UI element against host/golden/.
+*/
+
+#include <Adafruit_GFX.h>
+
+// Same color constants as Adafruit_ST77xx.h
+#define ST77XX_BLACK   0x0000
+#define ST77XX_WHITE   0xFFFF
+#define ST77XX_RED     0xF800
+#define ST77XX_GREEN   0x07E0
+#define ST77XX_BLUE    0x001F
+#define ST77XX_CYAN    0x07FF
+#define ST77XX_MAGENTA 0xF81F
+#define ST77XX_YELLOW  0xFFE0
+#define ST77XX_ORANGE  0xFC00
+
+// Bus cost of one frame (or of everything since the last resetStats())
+struct FrameStats {
+  const char   *label;
+  unsigned long transactions;   // outermost startWrite()/endWrite() pairs
+  unsigned long addrWindows;    // CASET/RASET/RAMWR sequences
+  unsigned long pixels;         // RGB565 pixels pushed
+  unsigned long bytes;          // total bytes that would cross SPI
+  unsigned long budget;         // byte budget in force (0 = none)
+  bool          withinBudget;
+};
+
+class Adafruit_ST7789 : public Adafruit_GFX {
+public:
+  Adafruit_ST7789(int8_t cs, int8_t dc, int8_t rst);
+  ~Adafruit_ST7789();
+
+  // Adafruit_ST7789 / Adafruit_SPITFT API used by the sketch
+  void init(uint16_t width, uint16_t height, uint8_t spiMode = 0);
+  void setRotation(uint8_t r) override;
+  void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+  void writePixels(uint16_t *colors, uint32_t len, bool block = true, bool bigEndian = false);
+  void writeColor(uint16_t color, uint32_t len);
+  uint16_t color565(uint8_t r, uint8_t g, uint8_t b) {
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+  }
+
+  // Primitives as overridden by Adafruit_SPITFT
+  void startWrite() override;
+  void endWrite() override;
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+  void writePixel(int16_t x, int16_t y, uint16_t color) override;
+  void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+  using Adafruit_GFX::drawRGBBitmap;
+  void drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h);
+
+  // ---- instrumentation ----
+  void beginFrame(const char *label);
+  FrameStats endFrame();                 // stats for the frame; prints a line when over budget
+  void setFrameByteBudget(unsigned long bytes) { budget_ = bytes; }
+  unsigned long budgetViolations() const { return violations_; }
+  const FrameStats &totals() const { return total_; }
+  void resetStats();
+
+  // ---- framebuffer access / snapshots ----
+  uint16_t pixelAt(int16_t x, int16_t y) const;
+  const uint16_t *framebuffer() const { return fb_; }
+  bool writePng(const char *path) const;
+  bool matchesGolden(const char *path) const; // byte-compares against a PNG written by writePng()
+  // Same for one region of the panel (one UI element)
+  bool writePng(const char *path, int16_t x, int16_t y, int16_t w, int16_t h) const;
+  bool matchesGolden(const char *path, int16_t x, int16_t y, int16_t w, int16_t h) const;
+
+private:
+  void account(unsigned long windows, unsigned long pixels);
+  void accountTransaction();
+  void store(int16_t x, int16_t y, uint16_t color);
+  bool clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const;
+  void allocFramebuffer();
+
+  uint16_t panelW_, panelH_;
+  uint16_t *fb_;
+  int writeDepth_;
+  // current address window + write pointer (for writePixels/writeColor)
+  int16_t winX_, winY_, winW_, winH_;
+  uint32_t winPos_;
+
+  FrameStats frame_;
+  FrameStats total_;
+  unsigned long budget_;
+  unsigned long violations_;
+};
+
+void printFrameStats(const FrameStats &s);
+
+#endif // HOST_ADAFRUIT_ST7789_H
@@ -0,0 +1,166 @@
+/*
+  AlertReplay - replays a scripted sequence of WeatherSnapshots through AlertUtils
+  (host builds only)
+
+  AlertUtils.cpp is compiled into this file, so its window helper can be checked
+  directly. Each replay step changes the previous snapshot a little (a new "now"
+  value, one forecast slot, or the evaluation minute) and then calls alertsUpdate().
+  Three things are checked:
+    - rule evaluations: only rules whose field changed are evaluated (AlertStats.ruleEvals),
+      and nothing is evaluated for an unchanged snapshot and minute
+    - windows: windowBounds() for "today" and "tonight" before 09:00, between 09:00 and
+      18:00, after 18:00 and on the edges, for several city timezone offsets
+    - the active mask and the ticker-changed result of every step
+  The exit code is 1 when a check fails.
+
+  Build and run:
+    g++ -std=gnu++17 -O2 -Ihost -o alert_replay host/AlertReplay.cpp host/HostArduino.cpp
+    ./alert_replay
+*/
+
+#include "../AlertUtils.cpp"
+#include <stdio.h>
+
+static int s_checks = 0;
+static int s_failed = 0;
+
+static void check(bool ok, const char *what) {
+  s_checks++;
+  if (ok) return;
+  s_failed++;
+  printf("FAIL %s\n", what);
+}
+
+// -------------------------- windows --------------------------
+static void checkWindow(AlertWindow window, int32_t tz, int localHour, int localMin,
+                        uint32_t wantFromLocalSec, int32_t wantToLocalSec, bool fromIsNow) {
+  // local midnight of a fixed day, as UTC
+  const uint32_t DAY = 1760054400UL - (1760054400UL % 86400UL);   // 2025-10-10 00:00
+  WeatherSnapshot snap = {};
+  snap.tzOffset = tz;
+  uint32_t midnightUtc = (uint32_t)((long)DAY - tz);
+  uint32_t now = midnightUtc + localHour * 3600UL + localMin * 60UL;
+
+  AlertField f = {};
+  f.metric = METRIC_TEMP;
+  f.agg = AGG_MAX;
+  f.window = window;
+  uint32_t from, to;
+  windowBounds(f, snap, now, from, to);
+
+  uint32_t wantFrom = fromIsNow ? now : midnightUtc + wantFromLocalSec;
+  uint32_t wantTo = (uint32_t)((long)midnightUtc + wantToLocalSec);
+  char what[128];
+  snprintf(what, sizeof(what), "%s at %02d:%02d, tz %+ld s: [%ld, %ld] want [%ld, %ld] (local s)",
+           window == WIN_TODAY ? "today" : "tonight", localHour, localMin, (long)tz,
+           (long)from - (long)midnightUtc, (long)to - (long)midnightUtc,
+           (long)wantFrom - (long)midnightUtc, (long)wantTo - (long)midnightUtc);
+  check(from == wantFrom && to == wantTo, what);
+}
+
+static void checkWindows() {
+  const int32_t TZS[] = { 0, -4 * 3600, -10 * 3600, 19800 /* +5:30 */, 13 * 3600 };
+  const long H = 3600;
+  for (int32_t tz : TZS) {
+    // today: now .. the last second of the city-local day
+    for (int hour : { 0, 7, 9, 12, 18, 20, 23 }) {
+      checkWindow(WIN_TODAY, tz, hour, 30, 0, 24 * H - 1, true);
+    }
+    // tonight before 09:00: the current night, now .. 09:00
+    checkWindow(WIN_TONIGHT, tz, 0, 0, 0, 9 * H, true);
+    checkWindow(WIN_TONIGHT, tz, 7, 15, 0, 9 * H, true);
+    checkWindow(WIN_TONIGHT, tz, 8, 59, 0, 9 * H, true);
+    // 09:00 .. 18:00: the coming night
+    checkWindow(WIN_TONIGHT, tz, 9, 0, 18 * H, 33 * H, false);
+    checkWindow(WIN_TONIGHT, tz, 12, 0, 18 * H, 33 * H, false);
+    checkWindow(WIN_TONIGHT, tz, 17, 59, 18 * H, 33 * H, false);
+    // from 18:00: already inside the night, now .. 09:00 tomorrow
+    checkWindow(WIN_TONIGHT, tz, 18, 0, 0, 33 * H, true);
+    checkWindow(WIN_TONIGHT, tz, 20, 45, 0, 33 * H, true);
+    checkWindow(WIN_TONIGHT, tz, 23, 59, 0, 33 * H, true);
+  }
+}
+
+// -------------------------- replay --------------------------
+static const char *RULES =
+  "hot:   temp > 70          : Hot %vF\n"
+  "cold:  temp < 32          : Cold %vF\n"
+  "gusty: max(wind, 3h) > 20 : Wind %v mph\n"
+  "wet:   pop >= 50          : Rain %v%\n";
+const uint32_t HOT = 1u << 0, COLD = 1u << 1, GUSTY = 1u << 2, WET = 1u << 3;
+
+struct ReplayStep {
+  const char *what;
+  bool     newSeq;       // gateway/fetch: next snapshot sequence number
+  uint32_t advanceSec;   // nowcast: the evaluation minute moves
+  float    nowTemp;      // NAN = keep
+  float    nowPop;       // 0..1, NAN = keep
+  int      slot;         // forecast slot to change (-1 = none)
+  float    slotWind;
+  // expected
+  uint32_t evals;        // ruleEvals added by this step
+  uint32_t mask;
+  bool     changed;      // alertsUpdate() result (ticker text changed)
+};
+
+static const ReplayStep STEPS[] = {
+  { "first update evaluates every rule",  true,  0, NAN,  NAN,   -1, 0,    4, 0,                  false },
+  { "same snapshot and minute: skipped",  false, 0, NAN,  NAN,   -1, 0,    0, 0,                  false },
+  { "now temp 75: temp rules only",       true,  0, 75,   NAN,   -1, 0,    2, HOT,                true  },
+  { "wind 25 at +3h: window rule only",   true,  0, NAN,  NAN,    2, 25,   1, HOT | GUSTY,        true  },
+  { "new seq, same values: nothing",      true,  0, NAN,  NAN,   -1, 0,    0, HOT | GUSTY,        false },
+  { "minute moves, fields unchanged",     false, 60, NAN, NAN,   -1, 0,    0, HOT | GUSTY,        false },
+  { "now temp 28, pop 60%",               true,  0, 28,   0.60f, -1, 0,    3, COLD | GUSTY | WET, true  },
+  { "temp 27: same set, new %v text",     true,  0, 27,   NAN,   -1, 0,    2, COLD | GUSTY | WET, true  },
+  { "wind back to 10",                    true,  0, NAN,  NAN,    2, 10,   1, COLD | WET,         true  },
+  { "mild and dry: all clear",            true,  0, 50,   0.0f,  -1, 0,    3, 0,                  true  },
+};
+
+static void replay() {
+  initAlerts(RULES);
+
+  // city at UTC-4, evaluated at 12:00 local; 3-hour slots from 09:00
+  WeatherSnapshot snap = {};
+  snap.valid = true;
+  snap.tzOffset = -4 * 3600;
+  uint32_t noon = 1760054400UL - (1760054400UL % 86400UL) + 12 * 3600UL - snap.tzOffset;
+  snap.count = 16;
+  for (int i = 0; i < snap.count; ++i) {
+    snap.slots[i] = { (uint32_t)(noon - 3 * 3600UL + i * 3 * 3600UL), 60.0f, 10.0f, 0.10f, 50 };
+  }
+  snap.derived.valid = true;
+  snap.derived.computedAt = noon;
+  snap.derived.nowTemp = 60.0f;
+  snap.derived.feelsLike = 60.0f;
+  snap.derived.nowWind = 10.0f;
+  snap.derived.nowPop = 0.10f;
+  snap.derived.nowHumidity = 50;
+
+  for (const ReplayStep &s : STEPS) {
+    if (s.newSeq) snap.seq++;
+    snap.derived.computedAt += s.advanceSec;
+    if (!isnan(s.nowTemp)) snap.derived.nowTemp = snap.derived.feelsLike = s.nowTemp;
+    if (!isnan(s.nowPop)) snap.derived.nowPop = s.nowPop;
+    if (s.slot >= 0) snap.slots[s.slot].wind = s.slotWind;
+
+    uint32_t evalsBefore = getAlertStats().ruleEvals;
+    bool changed = alertsUpdate(snap);
+    uint32_t evals = getAlertStats().ruleEvals - evalsBefore;
+
+    char what[160];
+    snprintf(what, sizeof(what), "%s: evals %lu want %lu, mask %02lx want %02lx, changed %d want %d (\"%s\")",
+             s.what, (unsigned long)evals, (unsigned long)s.evals, (unsigned long)alertsActiveMask(),
+             (unsigned long)s.mask, changed, s.changed, alertsTickerText().c_str());
+    check(evals == s.evals && alertsActiveMask() == s.mask && changed == s.changed, what);
+  }
+  check(alertsTickerText().length() == 0, "ticker text empty once all clear");
+}
+
+int main() {
+  hostSerialMute(true);   // AlertUtils logs every transition
+  checkWindows();
+  replay();
+  hostSerialMute(false);
+  printf("alert replay: %d checks, %d failed\n", s_checks, s_failed);
+  return s_failed ? 1 : 0;
+}
@@ -0,0 +1,98 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+/*
+  Host stand-in for the Arduino/ESP32 core.
+  Lets the sketch modules (GraphUtils, LeftBoxUtils, UIUtils, ...) and the real
+  Adafruit_GFX library compile as a normal desktop program so they can be driven
+  against MockST7789 (see Adafruit_ST7789.h in this folder).
+
+  This folder is ignored by the Arduino IDE; put it first on the include path
+  of a host build, e.g.:
+    g++ -std=gnu++17 -Ihost -I<Adafruit_GFX dir> host/HostArduino.cpp host/MockST7789.cpp \
+        <Adafruit_GFX dir>/Adafruit_GFX.cpp UIUtils.cpp my_harness.cpp
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <algorithm>
+#include "WString.h"
+#include "Print.h"
+
+#ifndef ARDUINO
+#define ARDUINO 10819
+#endif
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+// Flash-resident data is plain memory on the host
+#define PROGMEM
+#define F(s) (s)
+#define pgm_read_byte(addr)    (*(const unsigned char *)(addr))
+#define pgm_read_word(addr)    (*(const unsigned short *)(addr))
+#define pgm_read_dword(addr)   (*(const unsigned long *)(addr))
+#define pgm_read_pointer(addr) ((void *)*(void *const *)(addr))
+
+using std::min;
+using std::max;
+using std::isnan;
+
+// ESP32 newlib has strlcpy; older glibc does not
+#if defined(__GLIBC__) && !(__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 38))
+inline size_t strlcpy(char *dst, const char *src, size_t size) {
+  size_t len = strlen(src);
+  if (size) {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = 0;
+  }
+  return len;
+}
+#endif
+
+#define constrain(v, lo, hi) ((v) < (lo) ? (lo) : ((v) > (hi) ? (hi) : (v)))
+
+// Timing (wall clock of the host process)
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void yield();
+
+// SNTP wall clock of the ESP32 core (host stand-in in HostNet.cpp: syncs once Wi-Fi is up)
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char *server1,
+                const char *server2 = nullptr, const char *server3 = nullptr);
+bool getLocalTime(struct tm *info, uint32_t ms = 5000);
+
+// Virtual clock (host only). hostClockStart() switches millis()/micros()/delay()/time()
+// to a simulated clock that moves only through delay() and hostClockAdvanceMs(), so
+// weeks of loop() run in seconds. millis()/micros() then wrap at 32 bits as on the
+// ESP32, and time() counts from 0 until the SNTP stand-in sets the wall clock.
+void hostClockStart(uint32_t startMillis, uint32_t startEpoch);
+bool hostClockVirtual();
+void hostClockAdvanceMs(uint32_t ms);
+uint64_t hostClockElapsedMs();            // since hostClockStart(); never wraps
+void hostClockSetWallClock(bool set);     // SNTP synced: time() returns epochs
+bool hostClockWallClockSet();
+
+void hostSerialMute(bool mute);           // drop Serial output (long simulations)
+void hostSerialInput(const char *text);   // queue bytes for Serial.read() (console)
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  int available();
+  int read();
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buf, size_t n) override;
+  using Print::write;
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // HOST_ARDUINO_H
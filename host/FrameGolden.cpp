@@ -0,0 +1,158 @@
+/*
+  FrameGolden - per-element bus budgets and golden images of the UI (host builds only)
+
+  The sketch is compiled as-is (like Simulator.cpp) and set up against a fixed,
+  synthetic forecast on the virtual clock, so every run draws the same pixels. Each UI
+  element is then drawn on its own, inside its own MockST7789 frame:
+    beginFrame(label) -> draw into `screen` -> displayFlush() -> endFrame()
+  With DISPLAY_FRAMEBUFFER (the default) the frame is what the flush of that element's
+  dirty strips puts on the bus; with DISPLAY_FRAMEBUFFER 0 it is the direct drawing.
+  Checked per element:
+    - bytes on the bus against the element's budget (BUDGETS below)
+    - the element's screen region against host/golden/<label>.png
+  The exit code is 1 on a budget overrun, a golden mismatch or a missing golden.
+
+  Build (same inputs as the simulator):
+    g++ -std=gnu++17 -O2 -Ihost -I<Adafruit_GFX dir> -I<ArduinoJson dir>/src -o frame_golden \
+        host/FrameGolden.cpp host/HostArduino.cpp host/HostNet.cpp host/MockST7789.cpp \
+        <Adafruit_GFX dir>/Adafruit_GFX.cpp *.cpp -lpthread
+  Run from the repository root:
+    ./frame_golden              # check
+    ./frame_golden --update     # rewrite the goldens after an intended visual change
+*/
+
+#include "../WeatherStationV5_copy_20250813090204.ino"
+#include "HostNet.h"
+#include "HTTPClient.h"
+#include <stdio.h>
+
+static const uint32_t START_EPOCH = 1760000000;   // 2025-10-09 08:53 UTC
+static const char *GOLDEN_DIR = "host/golden";
+
+// Synthetic /forecast: 40 slots on the 3-hour grid from boot, smooth daily swings
+static int forecastHandler(const String &url, String &body) {
+  (void)url;
+  uint32_t first = START_EPOCH - START_EPOCH % 10800 + 10800;
+  const long tz = -4 * 3600;
+  char buf[256];
+  body = "{\"cod\":\"200\",\"cnt\":40,\"list\":[";
+  for (int i = 0; i < 40; ++i) {
+    uint32_t dt = first + (uint32_t)i * 10800;
+    float hourLocal = fmodf((dt + tz) / 3600.0f, 24.0f);
+    float temp = 55 + 12 * sinf((hourLocal - 9) * (float)M_PI / 12) + 0.5f * i;
+    float wind = 8 + 6 * sinf(i * 0.4f);
+    float pop = 0.5f + 0.45f * sinf(i * 0.3f);
+    int humidity = 55 + (int)(30 * pop);
+    snprintf(buf, sizeof(buf),
+             "%s{\"dt\":%lu,\"main\":{\"temp\":%.2f,\"humidity\":%d},\"wind\":{\"speed\":%.2f},"
+             "\"pop\":%.2f,\"weather\":[{\"description\":\"light rain\"}]}",
+             i ? "," : "", (unsigned long)dt, temp, humidity, wind, pop);
+    body += buf;
+  }
+  snprintf(buf, sizeof(buf), "],\"city\":{\"name\":\"Simville\",\"timezone\":%ld}}", tz);
+  body += buf;
+  return HTTP_CODE_OK;
+}
+
+// -------------------------- elements --------------------------
+struct Element {
+  const char   *label;
+  unsigned long budget;        // bus bytes for one frame of the element
+  void        (*draw)(int step);
+  int           steps;         // frames drawn (each one checked against the budget)
+  int16_t       x, y, w, h;    // screen region compared with the golden
+};
+
+static void drawBoxes(int)  { drawLeftBoxes(leftBoxX, leftBoxY, leftBoxW, leftBoxH); }
+static_assert(NUM_GRAPHS == 4, "one drawGraphN() per graph");
+static void drawGraph0(int) { drawGraph(0); }
+static void drawGraph1(int) { drawGraph(1); }
+static void drawGraph2(int) { drawGraph(2); }
+static void drawGraph3(int) { drawGraph(3); }
+static void drawClock(int step) {
+  static const char *TIMES[] = { "09:25:00 AM", "09:25:01 AM", "12:59:59 PM" };
+  drawClockBottom(TIMES[step % 3]);
+}
+static void drawTicker(int step) {
+  tickerFrame(scrollSmallY, scrollSmallSpeed, millis() + step * smallScrollInterval);
+}
+
+static const unsigned long STRIP_BYTES = 2UL * 320 * DISPLAY_FB_STRIP;   // one dirty strip
+
+// Budgets: the element's rows, rounded up to dirty strips, plus window overhead.
+// A redraw that spills into more strips (or, with DISPLAY_FRAMEBUFFER 0, more windows)
+// than its element needs fails here before it costs frame time on the device.
+static Element s_elements[] = {
+  { "left_boxes",    12 * STRIP_BYTES, drawBoxes,  1,   0, 0, 0, 0 },
+  { "graph_temp",    12 * STRIP_BYTES, drawGraph0, 1,   0, 0, 0, 0 },
+  { "graph_wind",    12 * STRIP_BYTES, drawGraph1, 1,   0, 0, 0, 0 },
+  { "graph_pop",     12 * STRIP_BYTES, drawGraph2, 1,   0, 0, 0, 0 },
+  { "graph_humidity",12 * STRIP_BYTES, drawGraph3, 1,   0, 0, 0, 0 },
+  { "clock",          3 * STRIP_BYTES, drawClock,  3,   0, 0, 0, 0 },
+  { "ticker",         4 * STRIP_BYTES, drawTicker, 25,  0, 0, 0, 0 },
+};
+
+static void layoutRegions() {
+  for (Element &e : s_elements) {
+    if (!strcmp(e.label, "left_boxes")) {
+      e.x = leftBoxX; e.y = leftBoxY; e.w = leftBoxW; e.h = leftBoxH;
+    } else if (!strncmp(e.label, "graph_", 6)) {
+      e.x = graphX; e.y = graphY; e.w = graphW; e.h = graphH;
+    } else if (!strcmp(e.label, "clock")) {
+      e.x = 0; e.y = SCREEN_H - clockBandHeight; e.w = SCREEN_W; e.h = clockBandHeight;
+    } else {
+      e.x = 0; e.y = 0; e.w = SCREEN_W; e.h = TOP_BAND_H;
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  bool update = argc > 1 && !strcmp(argv[1], "--update");
+  if (argc > 1 && !update) {
+    printf("usage: frame_golden [--update]\n");
+    return 2;
+  }
+
+  hostClockStart(0, START_EPOCH);
+  hostHttpSetHandler(forecastHandler);
+  hostSerialMute(true);
+  setup();
+  layoutRegions();
+
+  // start from a black panel; every element is then drawn on its own
+  screen.fillScreen(ST77XX_BLACK);
+  displayFlush();
+  hostSerialMute(false);
+
+  int failed = 0;
+  printf("%-16s %6s %10s %10s  %s\n", "element", "frames", "max bytes", "budget", "golden");
+  for (const Element &e : s_elements) {
+    tft.setFrameByteBudget(e.budget);
+    unsigned long maxBytes = 0;
+    bool within = true;
+    for (int step = 0; step < e.steps; ++step) {
+      tft.beginFrame(e.label);
+      e.draw(step);
+      displayFlush();
+      FrameStats fs = tft.endFrame();
+      if (fs.bytes > maxBytes) maxBytes = fs.bytes;
+      within &= fs.withinBudget;
+    }
+
+    char path[96];
+    snprintf(path, sizeof(path), "%s/%s.png", GOLDEN_DIR, e.label);
+    const char *golden;
+    if (update) {
+      golden = tft.writePng(path, e.x, e.y, e.w, e.h) ? "written" : "WRITE FAILED";
+    } else {
+      golden = tft.matchesGolden(path, e.x, e.y, e.w, e.h) ? "ok" : "MISMATCH";
+    }
+    bool ok = within && (!strcmp(golden, "ok") || !strcmp(golden, "written"));
+    printf("%-16s %6d %10lu %10lu  %s%s\n", e.label, e.steps, maxBytes, e.budget, golden,
+           within ? "" : "  OVER BUDGET");
+    failed += !ok;
+  }
+  printf("frame golden: %d elements, %d failed\n", (int)(sizeof(s_elements) / sizeof(s_elements[0])), failed);
+  fflush(stdout);
+  _Exit(failed ? 1 : 0);   // the status server thread is still blocked in accept()
+}
@@ -0,0 +1,26 @@
+#ifndef HOST_FREENOVE_WS2812_H
+#define HOST_FREENOVE_WS2812_H
+
+// Host stand-in for the Freenove WS2812 driver: keeps the last colors, drives nothing.
+
+#include "Arduino.h"
+
+class Freenove_ESP32_WS2812 {
+public:
+  Freenove_ESP32_WS2812(uint16_t n = 8, uint8_t pin = 2, uint8_t channel = 0)
+    : count_(n < 8 ? n : 8) { (void)pin; (void)channel; memset(rgb_, 0, sizeof(rgb_)); }
+  bool begin() { return true; }
+  void setBrightness(uint8_t brightness) { (void)brightness; }
+  void setLedColorData(int index, uint8_t r, uint8_t g, uint8_t b) {
+    if (index < 0 || index >= count_) return;
+    rgb_[index][0] = r; rgb_[index][1] = g; rgb_[index][2] = b;
+  }
+  void show() { shows_++; }
+  unsigned long shows() const { return shows_; }
+private:
+  uint16_t count_;
+  uint8_t rgb_[8][3];
+  unsigned long shows_ = 0;
+};
+
+#endif // HOST_FREENOVE_WS2812_H
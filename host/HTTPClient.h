@@ -0,0 +1,26 @@
+#ifndef HOST_HTTPCLIENT_H
+#define HOST_HTTPCLIENT_H
+
+// Host stand-in for the ESP32 HTTPClient (GET only). Responses come from the handler
+// set with hostHttpSetHandler() (HostNet.h); requests fail without a Wi-Fi link.
+
+#include "Arduino.h"
+
+#define HTTP_CODE_OK                     200
+#define HTTPC_ERROR_CONNECTION_REFUSED   (-1)
+#define HTTPC_ERROR_READ_TIMEOUT         (-11)
+
+class HTTPClient {
+public:
+  bool begin(const String &url) { url_ = url; body_ = ""; return true; }
+  void setTimeout(uint16_t timeoutMs) { timeoutMs_ = timeoutMs; }
+  int GET();
+  String getString() { return body_; }
+  void end() { body_ = ""; }
+private:
+  String url_;
+  String body_;
+  uint16_t timeoutMs_ = 5000;
+};
+
+#endif // HOST_HTTPCLIENT_H
@@ -0,0 +1,117 @@
+#include "Arduino.h"
+#include "SPI.h"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+// Host implementations of the core functions declared in host/Arduino.h
+
+HardwareSerial Serial;
+SPIClass SPI;
+
+static const std::chrono::steady_clock::time_point s_boot = std::chrono::steady_clock::now();
+
+// Virtual clock (read by the status server thread too)
+static std::atomic<bool>     s_virtual(false);
+static std::atomic<uint64_t> s_virtUs(0);       // includes the start offset
+static uint64_t              s_startUs = 0;
+static uint32_t              s_startEpoch = 0;
+static std::atomic<bool>     s_wallClock(false);
+static bool                  s_serialMute = false;
+static std::string           s_serialIn;          // queued console input
+static size_t                s_serialInPos = 0;
+
+unsigned long millis() {
+  if (s_virtual) return (uint32_t)(s_virtUs / 1000);
+  return (unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(
+           std::chrono::steady_clock::now() - s_boot).count();
+}
+
+unsigned long micros() {
+  if (s_virtual) return (uint32_t)s_virtUs;
+  return (unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(
+           std::chrono::steady_clock::now() - s_boot).count();
+}
+
+void delay(unsigned long ms) {
+  if (s_virtual) {
+    s_virtUs += (uint64_t)ms * 1000;
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void yield() {}
+
+void hostClockStart(uint32_t startMillis, uint32_t startEpoch) {
+  s_startUs = (uint64_t)startMillis * 1000;
+  s_virtUs = s_startUs;
+  s_startEpoch = startEpoch;
+  s_wallClock = false;
+  s_virtual = true;
+}
+
+bool hostClockVirtual() {
+  return s_virtual;
+}
+
+void hostClockAdvanceMs(uint32_t ms) {
+  s_virtUs += (uint64_t)ms * 1000;
+}
+
+uint64_t hostClockElapsedMs() {
+  return (s_virtUs - s_startUs) / 1000;
+}
+
+void hostClockSetWallClock(bool set) {
+  s_wallClock = set;
+}
+
+bool hostClockWallClockSet() {
+  return !s_virtual || s_wallClock;
+}
+
+// Replaces the C library's time() so modules calling time(NULL) follow the virtual clock
+extern "C" time_t time(time_t *out) noexcept {
+  time_t now;
+  if (s_virtual) {
+    uint64_t secs = (s_virtUs - s_startUs) / 1000000;
+    now = (time_t)(s_wallClock ? s_startEpoch + secs : secs);
+  } else {
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    now = ts.tv_sec;
+  }
+  if (out) *out = now;
+  return now;
+}
+
+void hostSerialMute(bool mute) {
+  s_serialMute = mute;
+}
+
+void hostSerialInput(const char *text) {
+  s_serialIn.erase(0, s_serialInPos);
+  s_serialInPos = 0;
+  s_serialIn += text;
+}
+
+int HardwareSerial::available() {
+  return (int)(s_serialIn.size() - s_serialInPos);
+}
+
+int HardwareSerial::read() {
+  return s_serialInPos < s_serialIn.size() ? (uint8_t)s_serialIn[s_serialInPos++] : -1;
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (s_serialMute) return 1;
+  fputc(c, stdout);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buf, size_t n) {
+  if (s_serialMute) return n;
+  return fwrite(buf, 1, n, stdout);
+}
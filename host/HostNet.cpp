@@ -0,0 +1,152 @@
+#include "HostNet.h"
+#include "WiFi.h"
+#include "HTTPClient.h"
+
+// Host implementations of WiFi.h, HTTPClient.h and the SNTP calls of Arduino.h
+
+WiFiClass WiFi;
+
+enum LinkState { LINK_IDLE, LINK_CONNECTING, LINK_UP };
+
+static wifi_mode_t s_mode = WIFI_OFF;
+static wifi_ps_type_t s_sleep = WIFI_PS_MIN_MODEM;
+static LinkState s_link = LINK_IDLE;
+static uint32_t s_linkSince = 0;          // millis() when the current attempt started
+static bool s_autoReconnect = true;
+static uint8_t s_bssid[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, 0x01 };
+
+static uint32_t s_associateMs = 800;
+static uint32_t s_httpMs = 300;
+static HostNetFaultHook s_faultHook = nullptr;
+static HostHttpHandler s_httpHandler = nullptr;
+static HostNetStats s_stats = {};
+
+// SNTP stand-in
+static long s_tzOffset = 0;
+static bool s_ntpPending = false;
+
+static bool allowed(HostNetOp op) {
+  return !s_faultHook || s_faultHook(op);
+}
+
+void hostNetSetFaultHook(HostNetFaultHook hook) { s_faultHook = hook; }
+void hostHttpSetHandler(HostHttpHandler handler) { s_httpHandler = handler; }
+
+void hostNetSetLatency(uint32_t associateMs, uint32_t httpMs) {
+  s_associateMs = associateMs;
+  s_httpMs = httpMs;
+}
+
+HostNetStats hostNetStats() { return s_stats; }
+
+// -------------------------- WiFi --------------------------
+wl_status_t WiFiClass::begin(const char *ssid, const char *passphrase, int32_t channel,
+                             const uint8_t *bssid, bool connect) {
+  (void)ssid; (void)passphrase; (void)channel; (void)bssid;
+  if (s_mode == WIFI_OFF) s_mode = WIFI_STA;
+  if (!connect) return WL_DISCONNECTED;
+  s_link = LINK_CONNECTING;
+  s_linkSince = millis();
+  s_stats.associations++;
+  return WL_DISCONNECTED;
+}
+
+wl_status_t WiFiClass::status() {
+  if (s_mode == WIFI_OFF) return WL_DISCONNECTED;
+  if (s_link == LINK_UP && !allowed(HOST_NET_LINK)) {
+    s_stats.linkDrops++;
+    s_link = s_autoReconnect ? LINK_CONNECTING : LINK_IDLE;
+    s_linkSince = millis();
+    return WL_CONNECTION_LOST;
+  }
+  if (s_link == LINK_CONNECTING && (uint32_t)(millis() - s_linkSince) >= s_associateMs) {
+    if (allowed(HOST_NET_ASSOCIATE)) {
+      s_link = LINK_UP;
+    } else {
+      s_stats.associateFailures++;
+      s_linkSince = millis();             // the driver keeps retrying
+    }
+  }
+  if (s_link == LINK_UP && s_ntpPending) {
+    s_ntpPending = false;
+    s_stats.ntpSyncs++;
+    hostClockSetWallClock(true);
+  }
+  return s_link == LINK_UP ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp) {
+  (void)eraseAp;
+  s_link = LINK_IDLE;
+  if (wifiOff) s_mode = WIFI_OFF;
+  return true;
+}
+
+bool WiFiClass::mode(wifi_mode_t m) {
+  s_mode = m;
+  if (m == WIFI_OFF) s_link = LINK_IDLE;
+  return true;
+}
+
+wifi_mode_t WiFiClass::getMode() { return s_mode; }
+
+bool WiFiClass::setSleep(bool enabled) {
+  s_sleep = enabled ? WIFI_PS_MIN_MODEM : WIFI_PS_NONE;
+  return true;
+}
+
+bool WiFiClass::setSleep(wifi_ps_type_t type) {
+  s_sleep = type;
+  return true;
+}
+
+wifi_ps_type_t WiFiClass::getSleep() { return s_sleep; }
+
+bool WiFiClass::setAutoReconnect(bool autoReconnect) {
+  s_autoReconnect = autoReconnect;
+  return true;
+}
+
+void WiFiClass::persistent(bool persistent) { (void)persistent; }
+
+IPAddress WiFiClass::localIP() {
+  return s_link == LINK_UP ? IPAddress(192, 168, 1, 50) : IPAddress();
+}
+
+int32_t WiFiClass::channel() { return 6; }
+uint8_t *WiFiClass::BSSID() { return s_bssid; }
+int8_t WiFiClass::RSSI() { return s_link == LINK_UP ? -58 : 0; }
+
+// -------------------------- HTTP --------------------------
+int HTTPClient::GET() {
+  s_stats.httpRequests++;
+  if (WiFi.status() != WL_CONNECTED) {
+    s_stats.httpFailures++;
+    return HTTPC_ERROR_CONNECTION_REFUSED;
+  }
+  if (!allowed(HOST_NET_HTTP)) {
+    delay(timeoutMs_);
+    s_stats.httpFailures++;
+    return HTTPC_ERROR_READ_TIMEOUT;
+  }
+  delay(s_httpMs);
+  return s_httpHandler ? s_httpHandler(url_, body_) : 404;
+}
+
+// -------------------------- SNTP --------------------------
+void configTime(long gmtOffsetSec, int daylightOffsetSec, const char *server1,
+                const char *server2, const char *server3) {
+  (void)server1; (void)server2; (void)server3;
+  s_tzOffset = gmtOffsetSec + daylightOffsetSec;
+  s_ntpPending = true;
+  WiFi.status(); // syncs right away when the link is up
+}
+
+bool getLocalTime(struct tm *info, uint32_t ms) {
+  (void)ms;
+  if (s_ntpPending) WiFi.status();
+  if (!hostClockWallClockSet()) return false;
+  time_t local = time(NULL) + s_tzOffset;
+  gmtime_r(&local, info);
+  return true;
+}
@@ -0,0 +1,43 @@
+#ifndef HOST_NET_H
+#define HOST_NET_H
+
+/*
+  HostNet - controls for the host Wi-Fi / HTTP / SNTP stand-ins (WiFi.h, HTTPClient.h)
+  - Association takes hostNetSetLatency() ms of (virtual) time; HTTP requests take
+    their own latency and are answered by a handler (default: 404).
+  - The fault hook is asked before each association completes, while a link is up
+    (returning false drops it) and before each HTTP request (false = read timeout
+    after the client's timeout), so a simulation can script outages and flaky APIs.
+  - configTime() "syncs" once the link is up: time() then returns epochs (see the
+    virtual clock in Arduino.h).
+*/
+
+#include "Arduino.h"
+
+enum HostNetOp {
+  HOST_NET_ASSOCIATE,   // an association attempt is about to complete
+  HOST_NET_LINK,        // an established link is checked (WiFi.status())
+  HOST_NET_HTTP,        // an HTTP request is about to be answered
+};
+
+// Return false to make the operation fail
+typedef bool (*HostNetFaultHook)(HostNetOp op);
+void hostNetSetFaultHook(HostNetFaultHook hook);
+
+// Fills body for a GET of url and returns the HTTP status code
+typedef int (*HostHttpHandler)(const String &url, String &body);
+void hostHttpSetHandler(HostHttpHandler handler);
+
+void hostNetSetLatency(uint32_t associateMs, uint32_t httpMs);
+
+struct HostNetStats {
+  uint32_t associations;       // WiFi.begin() calls
+  uint32_t associateFailures;  // attempts refused by the fault hook
+  uint32_t linkDrops;          // established links dropped by the fault hook
+  uint32_t httpRequests;
+  uint32_t httpFailures;       // no link, or refused by the fault hook
+  uint32_t ntpSyncs;
+};
+HostNetStats hostNetStats();
+
+#endif // HOST_NET_H
@@ -0,0 +1,172 @@
+/*
+  LedFrames - checks the LED frame generator (LedUtils) on the host
+
+  LedUtils.cpp is compiled into this file (no playback task off the ESP32). Checked:
+    - the gamma 2.2 * brightness lookup table at full, default and zero brightness
+    - conditions -> scene: temperature bands, rain before wind, NAN inputs
+    - frames per period for each effect (LED_TICK_MS per frame, capped at LED_MAX_FRAMES)
+    - generated frames: breathing range, the flash halves, rain pulses along the strip
+  The exit code is 1 when a check fails.
+
+  Build and run:
+    g++ -std=gnu++17 -O2 -Ihost -o led_frames host/LedFrames.cpp host/HostArduino.cpp
+    ./led_frames
+*/
+
+#include "../LedUtils.cpp"
+#include <stdio.h>
+
+// ledUpdateFromSnapshot() is not exercised here; this keeps WeatherUtils out of the build
+const WeatherSnapshot &getWeatherSnapshot() {
+  static WeatherSnapshot snap = {};
+  return snap;
+}
+
+static int s_checks = 0;
+static int s_failed = 0;
+
+static void check(bool ok, const char *what) {
+  s_checks++;
+  if (ok) return;
+  s_failed++;
+  printf("FAIL %s\n", what);
+}
+
+static void checkInt(long got, long want, const char *what) {
+  char buf[128];
+  snprintf(buf, sizeof(buf), "%s: %ld want %ld", what, got, want);
+  check(got == want, buf);
+}
+
+// -------------------------- lookup table --------------------------
+static void checkLut() {
+  ledSetBrightness(255);
+  checkInt(s_lut[0], 0, "lut[0] at 255");
+  checkInt(s_lut[255], 255, "lut[255] at 255");
+  checkInt(s_lut[128], 56, "lut[128] at 255 (gamma 2.2)");
+  checkInt(s_lut[64], 12, "lut[64] at 255");
+  bool monotonic = true;
+  for (int i = 1; i < 256; ++i) monotonic &= s_lut[i] >= s_lut[i - 1];
+  check(monotonic, "lut monotonic at 255");
+
+  ledSetBrightness(64);
+  checkInt(s_lut[255], 64, "lut[255] at 64");
+  checkInt(s_lut[128], 14, "lut[128] at 64");
+
+  ledSetBrightness(0);
+  int lit = 0;
+  for (int i = 0; i < 256; ++i) lit += s_lut[i] != 0;
+  checkInt(lit, 0, "lut entries lit at brightness 0");
+
+  checkInt(s_wave[0], 0, "wave[0]");
+  checkInt(s_wave[128], 255, "wave[128] (peak)");
+  ledSetBrightness(255);
+}
+
+// -------------------------- scene selection --------------------------
+struct SceneCase {
+  float     temp, wind, pop;
+  LedEffect effect;
+  uint8_t   r, g, b;
+  uint8_t   depth;
+  uint16_t  periodMs;
+};
+
+static const SceneCase SCENES[] = {
+  { NAN,  NAN,  NAN,  LED_EFFECT_BREATHE, 80,  80,  80,  90,  2560 },   // no data: grey
+  { 20,   5,    0.0f, LED_EFFECT_BREATHE, 180, 220, 255, 90,  2560 },   // freezing
+  { 40,   5,    0.1f, LED_EFFECT_BREATHE, 0,   160, 200, 90,  2560 },   // cold
+  { 60,   5,    0.1f, LED_EFFECT_BREATHE, 40,  200, 60,  90,  2560 },   // mild
+  { 75,   5,    0.1f, LED_EFFECT_BREATHE, 255, 150, 0,   90,  2560 },   // warm
+  { 90,   5,    0.1f, LED_EFFECT_BREATHE, 255, 40,  0,   90,  2560 },   // hot
+  { 60,   20,   0.1f, LED_EFFECT_GUST,    40,  200, 60,  160, 1600 },   // wind 20 mph
+  { 60,   40,   NAN,  LED_EFFECT_GUST,    40,  200, 60,  255, 1600 },   // depth saturates
+  { 60,   20,   0.3f, LED_EFFECT_RAIN,    40,  200, 60,  120, 2176 },   // rain wins over wind
+  { 60,   NAN,  1.0f, LED_EFFECT_RAIN,    40,  200, 60,  255, 1280 },   // certain rain
+};
+
+static void checkScenes() {
+  for (const SceneCase &c : SCENES) {
+    LedScene s = ledSceneFromConditions(c.temp, c.wind, c.pop);
+    char what[160];
+    snprintf(what, sizeof(what),
+             "scene(%.0f F, %.0f mph, pop %.1f): effect %d rgb %d,%d,%d depth %d period %d, "
+             "want %d %d,%d,%d %d %d",
+             c.temp, c.wind, c.pop, s.effect, s.r, s.g, s.b, s.depth, s.periodMs,
+             c.effect, c.r, c.g, c.b, c.depth, c.periodMs);
+    check(s.effect == c.effect && s.r == c.r && s.g == c.g && s.b == c.b &&
+          s.depth == c.depth && s.periodMs == c.periodMs, what);
+  }
+  LedScene a = ledSceneFromConditions(60, 5, 0.1f), b = ledSceneFromConditions(65, 8, 0.2f);
+  check(ledSceneEquals(a, b), "same band and effect compare equal (no rebuild)");
+  b = ledSceneFromConditions(72, 8, 0.2f);
+  check(!ledSceneEquals(a, b), "new band compares different");
+}
+
+// -------------------------- frame tables --------------------------
+static uint8_t s_table[LED_MAX_FRAMES][LED_MAX_COUNT * 3];
+
+static void checkFrameCounts() {
+  LedScene s = ledSceneFromConditions(60, 5, 0.1f);
+  checkInt(ledBuildFrameTable(s, 8, s_table), 2560 / LED_TICK_MS, "breathe frames");
+  s = ledSceneFromConditions(60, 20, 0.1f);
+  checkInt(ledBuildFrameTable(s, 8, s_table), 1600 / LED_TICK_MS, "gust frames");
+  s = ledSceneFromConditions(60, 5, 1.0f);
+  checkInt(ledBuildFrameTable(s, 8, s_table), 1280 / LED_TICK_MS, "rain frames at pop 1.0");
+  LedScene flash = {};
+  flash.effect = LED_EFFECT_FLASH;
+  flash.periodMs = 1000;
+  checkInt(ledBuildFrameTable(flash, 8, s_table), 1000 / LED_TICK_MS, "flash frames");
+  LedScene off = {};
+  checkInt(ledBuildFrameTable(off, 8, s_table), 1, "off frames");
+  LedScene slow = ledSceneFromConditions(60, 5, 0.1f);
+  slow.periodMs = 10000;
+  checkInt(ledBuildFrameTable(slow, 8, s_table), LED_MAX_FRAMES, "long period capped");
+  slow.periodMs = 5;
+  checkInt(ledBuildFrameTable(slow, 8, s_table), 1, "short period: one frame");
+}
+
+static void checkFrames() {
+  ledSetBrightness(255);
+  uint8_t rgb[LED_MAX_COUNT * 3];
+
+  // breathing: dimmest at phase 0 (255 - depth), full base color mid-period
+  LedScene s = ledSceneFromConditions(75, 5, 0.1f);   // amber 255,150,0, depth 90
+  ledGenerateFrame(s, 64, 128, 1, rgb);
+  checkInt(rgb[0], 255, "breathe peak red");
+  checkInt(rgb[1], s_lut[150], "breathe peak green");
+  ledGenerateFrame(s, 0, 128, 1, rgb);
+  checkInt(rgb[0], s_lut[scale8(255, 165)], "breathe trough red");
+
+  // flash: base color for the first half, off (depth 255) for the second
+  LedScene f = {};
+  f.effect = LED_EFFECT_FLASH;
+  f.r = 255; f.periodMs = 1000; f.depth = 255;
+  int frames = ledBuildFrameTable(f, 2, s_table);
+  int on = 0;
+  for (int i = 0; i < frames; ++i) on += s_table[i][0] == 255;
+  checkInt(on, frames / 2, "flash frames lit");
+  checkInt(s_table[frames - 1][3], 0, "flash second half dark (LED 1)");
+
+  // rain: LEDs are offset in phase, so the strip is not uniform
+  LedScene r = ledSceneFromConditions(60, 5, 0.8f);
+  ledGenerateFrame(r, 0, 64, 4, rgb);
+  check(rgb[2] != rgb[2 + 2 * 3], "rain pulse differs along the strip");
+
+  // every LED of a breathing frame is the same color
+  ledGenerateFrame(s, 10, 128, 8, rgb);
+  bool uniform = true;
+  for (int i = 1; i < 8; ++i) uniform &= memcmp(rgb, rgb + i * 3, 3) == 0;
+  check(uniform, "breathe frame uniform across LEDs");
+}
+
+int main() {
+  hostSerialMute(true);
+  checkLut();
+  checkScenes();
+  checkFrameCounts();
+  checkFrames();
+  hostSerialMute(false);
+  printf("led frames: %d checks, %d failed\n", s_checks, s_failed);
+  return s_failed ? 1 : 0;
+}
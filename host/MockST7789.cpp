@@ -0,0 +1,327 @@
+#include "Adafruit_ST7789.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+// ST7789 address-window sequence: CASET + 4 data, RASET + 4 data, RAMWR
+static const unsigned long ADDR_WINDOW_BYTES = 11;
+
+Adafruit_ST7789::Adafruit_ST7789(int8_t cs, int8_t dc, int8_t rst)
+  : Adafruit_GFX(240, 320), panelW_(240), panelH_(320), fb_(nullptr), writeDepth_(0),
+    winX_(0), winY_(0), winW_(0), winH_(0), winPos_(0),
+    budget_(0), violations_(0) {
+  (void)cs; (void)dc; (void)rst;
+  resetStats();
+}
+
+Adafruit_ST7789::~Adafruit_ST7789() {
+  free(fb_);
+}
+
+void Adafruit_ST7789::init(uint16_t width, uint16_t height, uint8_t spiMode) {
+  (void)spiMode;
+  panelW_ = width;
+  panelH_ = height;
+  setRotation(0);
+}
+
+void Adafruit_ST7789::setRotation(uint8_t r) {
+  rotation = r & 3;
+  if (rotation & 1) { _width = panelH_; _height = panelW_; }
+  else              { _width = panelW_; _height = panelH_; }
+  allocFramebuffer();
+}
+
+void Adafruit_ST7789::allocFramebuffer() {
+  free(fb_);
+  fb_ = (uint16_t *)calloc((size_t)_width * _height, sizeof(uint16_t));
+}
+
+// -------------------------- accounting --------------------------
+void Adafruit_ST7789::resetStats() {
+  memset(&total_, 0, sizeof(total_));
+  total_.label = "total";
+  total_.withinBudget = true;
+  memset(&frame_, 0, sizeof(frame_));
+  frame_.withinBudget = true;
+  violations_ = 0;
+}
+
+void Adafruit_ST7789::account(unsigned long windows, unsigned long pixels) {
+  unsigned long bytes = windows * ADDR_WINDOW_BYTES + pixels * 2;
+  total_.addrWindows += windows; total_.pixels += pixels; total_.bytes += bytes;
+  frame_.addrWindows += windows; frame_.pixels += pixels; frame_.bytes += bytes;
+}
+
+void Adafruit_ST7789::accountTransaction() {
+  total_.transactions++;
+  frame_.transactions++;
+}
+
+void Adafruit_ST7789::beginFrame(const char *label) {
+  memset(&frame_, 0, sizeof(frame_));
+  frame_.label = label;
+  frame_.budget = budget_;
+}
+
+FrameStats Adafruit_ST7789::endFrame() {
+  frame_.budget = budget_;
+  frame_.withinBudget = (budget_ == 0) || (frame_.bytes <= budget_);
+  if (!frame_.withinBudget) {
+    violations_++;
+    Serial.printf("[MockST7789] FRAME OVER BUDGET: %s used %lu bytes (budget %lu)\n",
+                  frame_.label ? frame_.label : "?", frame_.bytes, budget_);
+  }
+  return frame_;
+}
+
+void printFrameStats(const FrameStats &s) {
+  Serial.printf("[MockST7789] %-18s tx=%6lu win=%6lu px=%8lu bytes=%8lu%s\n",
+                s.label ? s.label : "?", s.transactions, s.addrWindows, s.pixels, s.bytes,
+                s.withinBudget ? "" : "  OVER BUDGET");
+}
+
+// -------------------------- framebuffer --------------------------
+void Adafruit_ST7789::store(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height || !fb_) return;
+  fb_[(size_t)y * _width + x] = color;
+}
+
+uint16_t Adafruit_ST7789::pixelAt(int16_t x, int16_t y) const {
+  if (x < 0 || y < 0 || x >= _width || y >= _height || !fb_) return 0;
+  return fb_[(size_t)y * _width + x];
+}
+
+// Same clipping rules as Adafruit_SPITFT::writeFillRect (negative sizes allowed)
+bool Adafruit_ST7789::clipRect(int16_t &x, int16_t &y, int16_t &w, int16_t &h) const {
+  if (w < 0) { x += w + 1; w = -w; }
+  if (h < 0) { y += h + 1; h = -h; }
+  if (w == 0 || h == 0 || x >= _width || y >= _height) return false;
+  int16_t x2 = x + w - 1, y2 = y + h - 1;
+  if (x2 < 0 || y2 < 0) return false;
+  if (x < 0) { x = 0; w = x2 + 1; }
+  if (y < 0) { y = 0; h = y2 + 1; }
+  if (x2 >= _width)  w = _width - x;
+  if (y2 >= _height) h = _height - y;
+  return true;
+}
+
+// -------------------------- SPITFT-equivalent primitives --------------------------
+void Adafruit_ST7789::startWrite() {
+  if (writeDepth_++ == 0) accountTransaction();
+}
+
+void Adafruit_ST7789::endWrite() {
+  if (writeDepth_ > 0) writeDepth_--;
+}
+
+void Adafruit_ST7789::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+  winX_ = x; winY_ = y; winW_ = w; winH_ = h; winPos_ = 0;
+  account(1, 0);
+}
+
+void Adafruit_ST7789::writePixels(uint16_t *colors, uint32_t len, bool block, bool bigEndian) {
+  (void)block;
+  account(0, len);
+  if (winW_ <= 0) return;
+  // one window row segment at a time (long soak runs push billions of pixels)
+  while (len > 0) {
+    int16_t col = (int16_t)(winPos_ % winW_);
+    int16_t y = winY_ + (int16_t)(winPos_ / winW_);
+    uint32_t n = min((uint32_t)(winW_ - col), len);
+    int16_t x = winX_ + col;
+    if (fb_ && y >= 0 && y < _height) {
+      uint16_t *row = fb_ + (size_t)y * _width;
+      for (uint32_t i = 0; i < n; ++i, ++x) {
+        if (x < 0 || x >= _width) continue;
+        uint16_t c = colors[i];
+        row[x] = bigEndian ? (uint16_t)((c >> 8) | (c << 8)) : c;
+      }
+    }
+    colors += n;
+    winPos_ += n;
+    len -= n;
+  }
+}
+
+void Adafruit_ST7789::writeColor(uint16_t color, uint32_t len) {
+  account(0, len);
+  if (winW_ <= 0) return;
+  for (uint32_t i = 0; i < len; ++i, ++winPos_) {
+    store(winX_ + winPos_ % winW_, winY_ + winPos_ / winW_, color);
+  }
+}
+
+void Adafruit_ST7789::writePixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  setAddrWindow(x, y, 1, 1);
+  writeColor(color, 1);
+}
+
+void Adafruit_ST7789::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (x < 0 || y < 0 || x >= _width || y >= _height) return;
+  startWrite();
+  writePixel(x, y, color);
+  endWrite();
+}
+
+void Adafruit_ST7789::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  if (!clipRect(x, y, w, h)) return;
+  setAddrWindow(x, y, w, h);
+  writeColor(color, (uint32_t)w * h);
+}
+
+void Adafruit_ST7789::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  writeFillRect(x, y, w, 1, color);
+}
+
+void Adafruit_ST7789::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  writeFillRect(x, y, 1, h, color);
+}
+
+void Adafruit_ST7789::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  int16_t cx = x, cy = y, cw = w, ch = h;
+  if (!clipRect(cx, cy, cw, ch)) return;
+  startWrite();
+  writeFillRect(cx, cy, cw, ch, color);
+  endWrite();
+}
+
+void Adafruit_ST7789::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  fillRect(x, y, w, 1, color);
+}
+
+void Adafruit_ST7789::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  fillRect(x, y, 1, h, color);
+}
+
+// One window for the whole bitmap, rows pushed back to back (as Adafruit_SPITFT does)
+void Adafruit_ST7789::drawRGBBitmap(int16_t x, int16_t y, uint16_t *pcolors, int16_t w, int16_t h) {
+  int16_t x2, y2;
+  if ((x >= _width) || (y >= _height) || ((x2 = (x + w - 1)) < 0) || ((y2 = (y + h - 1)) < 0)) return;
+  int16_t bx1 = 0, by1 = 0, saveW = w;
+  if (x < 0) { w += x; bx1 = -x; x = 0; }
+  if (y < 0) { h += y; by1 = -y; y = 0; }
+  if (x2 >= _width)  w = _width - x;
+  if (y2 >= _height) h = _height - y;
+  pcolors += by1 * saveW + bx1;
+  startWrite();
+  setAddrWindow(x, y, w, h);
+  while (h--) {
+    writePixels(pcolors, w, false);
+    pcolors += saveW;
+  }
+  endWrite();
+}
+
+// -------------------------- PNG snapshots --------------------------
+// Minimal encoder: 8-bit RGB, filter 0, zlib "stored" blocks. Output is deterministic,
+// so a golden image can be checked with a plain byte comparison.
+static uint32_t crc32Update(uint32_t crc, const uint8_t *p, size_t n) {
+  static uint32_t table[256];
+  static bool ready = false;
+  if (!ready) {
+    for (uint32_t i = 0; i < 256; ++i) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; ++k) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+    ready = true;
+  }
+  crc = ~crc;
+  while (n--) crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+static void putBE32(std::vector<uint8_t> &out, uint32_t v) {
+  out.push_back(v >> 24); out.push_back(v >> 16); out.push_back(v >> 8); out.push_back(v);
+}
+
+static void putChunk(std::vector<uint8_t> &out, const char *type, const std::vector<uint8_t> &data) {
+  putBE32(out, (uint32_t)data.size());
+  size_t start = out.size();
+  out.insert(out.end(), type, type + 4);
+  out.insert(out.end(), data.begin(), data.end());
+  putBE32(out, crc32Update(0, &out[start], out.size() - start));
+}
+
+// The w x h region at (x0, y0) of a framebuffer that is stride pixels wide
+static std::vector<uint8_t> encodePng(const uint16_t *fb, int stride, int x0, int y0, int w, int h) {
+  std::vector<uint8_t> raw;
+  raw.reserve((size_t)h * (1 + w * 3));
+  for (int y = 0; y < h; ++y) {
+    raw.push_back(0); // filter: none
+    for (int x = 0; x < w; ++x) {
+      uint16_t c = fb ? fb[(size_t)(y0 + y) * stride + x0 + x] : 0;
+      uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+      raw.push_back((r << 3) | (r >> 2));
+      raw.push_back((g << 2) | (g >> 4));
+      raw.push_back((b << 3) | (b >> 2));
+    }
+  }
+
+  std::vector<uint8_t> z;
+  z.push_back(0x78); z.push_back(0x01);
+  size_t pos = 0;
+  do {
+    size_t n = raw.size() - pos;
+    if (n > 65535) n = 65535;
+    bool last = (pos + n == raw.size());
+    z.push_back(last ? 1 : 0);
+    z.push_back(n & 0xFF); z.push_back(n >> 8);
+    z.push_back(~n & 0xFF); z.push_back((~n >> 8) & 0xFF);
+    z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + n);
+    pos += n;
+  } while (pos < raw.size());
+  uint32_t a = 1, b = 0;
+  for (uint8_t v : raw) { a = (a + v) % 65521; b = (b + a) % 65521; }
+  putBE32(z, (b << 16) | a);
+
+  std::vector<uint8_t> png = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  std::vector<uint8_t> ihdr;
+  putBE32(ihdr, w); putBE32(ihdr, h);
+  ihdr.push_back(8); ihdr.push_back(2); ihdr.push_back(0); ihdr.push_back(0); ihdr.push_back(0);
+  putChunk(png, "IHDR", ihdr);
+  putChunk(png, "IDAT", z);
+  putChunk(png, "IEND", std::vector<uint8_t>());
+  return png;
+}
+
+bool Adafruit_ST7789::writePng(const char *path) const {
+  return writePng(path, 0, 0, _width, _height);
+}
+
+bool Adafruit_ST7789::matchesGolden(const char *path) const {
+  return matchesGolden(path, 0, 0, _width, _height);
+}
+
+bool Adafruit_ST7789::writePng(const char *path, int16_t x, int16_t y, int16_t w, int16_t h) const {
+  if (!clipRect(x, y, w, h)) return false;
+  std::vector<uint8_t> png = encodePng(fb_, _width, x, y, w, h);
+  FILE *f = fopen(path, "wb");
+  if (!f) {
+    Serial.printf("[MockST7789] cannot write %s\n", path);
+    return false;
+  }
+  bool ok = fwrite(png.data(), 1, png.size(), f) == png.size();
+  fclose(f);
+  return ok;
+}
+
+bool Adafruit_ST7789::matchesGolden(const char *path, int16_t x, int16_t y, int16_t w, int16_t h) const {
+  if (!clipRect(x, y, w, h)) return false;
+  FILE *f = fopen(path, "rb");
+  if (!f) {
+    Serial.printf("[MockST7789] golden image %s missing\n", path);
+    return false;
+  }
+  std::vector<uint8_t> golden;
+  uint8_t buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) golden.insert(golden.end(), buf, buf + n);
+  fclose(f);
+  bool same = (golden == encodePng(fb_, _width, x, y, w, h));
+  if (!same) Serial.printf("[MockST7789] frame differs from golden %s\n", path);
+  return same;
+}
@@ -0,0 +1,85 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+// Host stand-in for the ESP32 Preferences (NVS) library: namespaces live in memory
+// for the life of the process, so a "reboot" inside one run keeps its data.
+
+#include "Arduino.h"
+#include <map>
+#include <string>
+#include <vector>
+
+class Preferences {
+public:
+  bool begin(const char *name, bool readOnly = false) {
+    ns_ = &store()[name];
+    readOnly_ = readOnly;
+    return true;
+  }
+  void end() { ns_ = nullptr; }
+  bool clear() { if (!writable()) return false; ns_->clear(); return true; }
+  bool remove(const char *key) { return writable() && ns_->erase(key) > 0; }
+  bool isKey(const char *key) { return ns_ && ns_->count(key) > 0; }
+
+  size_t putBytes(const char *key, const void *value, size_t len) {
+    if (!writable()) return 0;
+    const uint8_t *p = (const uint8_t *)value;
+    (*ns_)[key].assign(p, p + len);
+    return len;
+  }
+  size_t getBytesLength(const char *key) {
+    const std::vector<uint8_t> *v = find(key);
+    return v ? v->size() : 0;
+  }
+  size_t getBytes(const char *key, void *buf, size_t maxLen) {
+    const std::vector<uint8_t> *v = find(key);
+    if (!v || v->size() > maxLen) return 0;
+    memcpy(buf, v->data(), v->size());
+    return v->size();
+  }
+
+  size_t putInt(const char *key, int32_t value)     { return putBytes(key, &value, sizeof(value)); }
+  size_t putUInt(const char *key, uint32_t value)   { return putBytes(key, &value, sizeof(value)); }
+  size_t putULong(const char *key, uint32_t value)  { return putBytes(key, &value, sizeof(value)); }
+  size_t putFloat(const char *key, float value)     { return putBytes(key, &value, sizeof(value)); }
+  size_t putBool(const char *key, bool value)       { uint8_t b = value; return putBytes(key, &b, 1); }
+  size_t putUChar(const char *key, uint8_t value)   { return putBytes(key, &value, 1); }
+  size_t putString(const char *key, const char *value) { return putBytes(key, value, strlen(value)); }
+  size_t putString(const char *key, const String &value) { return putString(key, value.c_str()); }
+
+  int32_t getInt(const char *key, int32_t def = 0)      { return get(key, def); }
+  uint32_t getUInt(const char *key, uint32_t def = 0)   { return get(key, def); }
+  uint32_t getULong(const char *key, uint32_t def = 0)  { return get(key, def); }
+  float getFloat(const char *key, float def = NAN)      { return get(key, def); }
+  bool getBool(const char *key, bool def = false)       { return get<uint8_t>(key, def) != 0; }
+  uint8_t getUChar(const char *key, uint8_t def = 0)    { return get(key, def); }
+  String getString(const char *key, const String &def = String()) {
+    const std::vector<uint8_t> *v = find(key);
+    return v ? String(std::string(v->begin(), v->end())) : def;
+  }
+
+private:
+  typedef std::map<std::string, std::vector<uint8_t> > Namespace;
+  static std::map<std::string, Namespace> &store() {
+    static std::map<std::string, Namespace> s;
+    return s;
+  }
+  bool writable() const { return ns_ && !readOnly_; }
+  const std::vector<uint8_t> *find(const char *key) const {
+    if (!ns_) return nullptr;
+    Namespace::const_iterator it = ns_->find(key);
+    return it == ns_->end() ? nullptr : &it->second;
+  }
+  template <class T> T get(const char *key, T def) {
+    const std::vector<uint8_t> *v = find(key);
+    if (!v || v->size() != sizeof(T)) return def;
+    T out;
+    memcpy(&out, v->data(), sizeof(T));
+    return out;
+  }
+
+  Namespace *ns_ = nullptr;
+  bool readOnly_ = false;
+};
+
+#endif // HOST_PREFERENCES_H
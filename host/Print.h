@@ -0,0 +1,66 @@
+#ifndef HOST_PRINT_H
+#define HOST_PRINT_H
+
+// Host stand-in for the Arduino Print base class (what Serial and Adafruit_GFX derive from).
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include "WString.h"
+
+#define DEC 10
+#define HEX 16
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buf, size_t n) {
+    size_t out = 0;
+    while (n--) out += write(*buf++);
+    return out;
+  }
+  size_t write(const char *s) { return s ? write((const uint8_t *)s, strlen(s)) : 0; }
+
+  size_t print(const char *s)   { return write(s); }
+  size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+  size_t print(char c)          { return write((uint8_t)c); }
+  size_t print(int v, int base = DEC)           { return printNum(v, base); }
+  size_t print(unsigned int v, int base = DEC)  { return printUNum(v, base); }
+  size_t print(long v, int base = DEC)          { return printNum(v, base); }
+  size_t print(unsigned long v, int base = DEC) { return printUNum(v, base); }
+  size_t print(double v, int digits = 2) {
+    char b[48];
+    snprintf(b, sizeof(b), "%.*f", digits, v);
+    return write(b);
+  }
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T &v) { size_t n = print(v); return n + println(); }
+  template <typename T> size_t println(const T &v, int arg) { size_t n = print(v, arg); return n + println(); }
+
+  size_t printf(const char *fmt, ...) __attribute__((format(printf, 2, 3))) {
+    char b[512];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(b, sizeof(b), fmt, ap);
+    va_end(ap);
+    if (n < 0) return 0;
+    return write((const uint8_t *)b, (size_t)n < sizeof(b) ? (size_t)n : sizeof(b) - 1);
+  }
+
+private:
+  size_t printNum(long v, int base) {
+    if (base == DEC) { char b[24]; snprintf(b, sizeof(b), "%ld", v); return write(b); }
+    return printUNum((unsigned long)v, base);
+  }
+  size_t printUNum(unsigned long v, int base) {
+    char b[24];
+    snprintf(b, sizeof(b), base == HEX ? "%lX" : "%lu", v);
+    return write(b);
+  }
+};
+
+#endif // HOST_PRINT_H
@@ -0,0 +1,274 @@
+/*
+  RelayLoopback - runs a relay gateway and subscriber against each other over loopback
+  (host builds only)
+
+  RelayUtils.cpp is compiled into this file, so both ends run in one process:
+    - packing: relayPack() -> relayUnpack() keeps seq, city, every slot and the
+      "missing" markers; bad length, magic, version, slot count and CRC are rejected
+    - multicast: relayPublish() -> gateway task -> RELAY_GROUP -> subscriber task ->
+      relayTakeLatest() hands each new seq out once; resends of the same seq and
+      packets with a bad CRC are not handed out (relayHeardWithin() still follows resends)
+    - HTTP fallback: a loopback server answers GET /forecast.bin the way StatusUtils does
+      (header + one RelayPacket); relayFetchHttp() -> relayUnpack() takes a good body
+      and rejects a corrupted one, a non-200 reply and a host name too long to request
+  The multicast part needs a route for 239.0.0.0/8 (any default route will do); without
+  one it is skipped with a note, the rest still runs. The exit code is 1 when a check fails.
+
+  Build and run:
+    g++ -std=gnu++17 -O2 -Ihost -o relay_loopback host/RelayLoopback.cpp host/HostArduino.cpp -lpthread
+    ./relay_loopback
+*/
+
+#include "../RelayUtils.cpp"
+#include <stdio.h>
+#include <atomic>
+
+static int s_checks = 0;
+static int s_failed = 0;
+
+static void check(bool ok, const char *what) {
+  s_checks++;
+  if (ok) return;
+  s_failed++;
+  printf("FAIL %s\n", what);
+}
+
+static WeatherSnapshot makeSnapshot(uint32_t seq) {
+  WeatherSnapshot snap = {};
+  snap.valid = true;
+  snap.seq = seq;
+  snap.fetchedAt = 1760000000UL + seq * 600UL;
+  snap.tzOffset = -4 * 3600;
+  strlcpy(snap.city, "Loopbackville", sizeof(snap.city));
+  strlcpy(snap.desc, "light rain", sizeof(snap.desc));
+  snap.count = SNAPSHOT_MAX_SLOTS;
+  for (int i = 0; i < snap.count; ++i) {
+    snap.slots[i] = { (uint32_t)(snap.fetchedAt + i * 10800UL), 50.0f + i * 0.5f, 3.0f + (i % 7) * 1.3f,
+                      (i % 10) / 10.0f, (int8_t)(40 + i) };
+  }
+  snap.slots[3].temp = NAN;
+  snap.slots[4].wind = NAN;
+  snap.slots[5].pop = NAN;
+  snap.slots[6].humidity = -1;
+  return snap;
+}
+
+// Values survive the wire at its resolution (0.1 °F, 0.1 mph, 1 %); NAN stays NAN
+static bool sameValue(float a, float b, float step) {
+  if (isnan(a) || isnan(b)) return isnan(a) && isnan(b);
+  return fabsf(a - b) <= step / 2;
+}
+
+static bool sameSnapshot(const WeatherSnapshot &a, const WeatherSnapshot &b) {
+  if (a.seq != b.seq || a.fetchedAt != b.fetchedAt || a.tzOffset != b.tzOffset) return false;
+  if (a.valid != b.valid || a.count != b.count) return false;
+  if (strcmp(a.city, b.city) != 0 || strcmp(a.desc, b.desc) != 0) return false;
+  for (int i = 0; i < a.count; ++i) {
+    const ForecastSlot &x = a.slots[i], &y = b.slots[i];
+    if (x.dt != y.dt || x.humidity != y.humidity) return false;
+    if (!sameValue(x.temp, y.temp, 0.1f) || !sameValue(x.wind, y.wind, 0.1f) || !sameValue(x.pop, y.pop, 0.01f)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// -------------------------- packing --------------------------
+static void checkPacking() {
+  WeatherSnapshot snap = makeSnapshot(41);
+  static RelayPacket pkt;
+  relayPack(snap, pkt);
+  static WeatherSnapshot out;
+  out = {};
+  check(relayUnpack(&pkt, sizeof(pkt), out), "unpack a packed snapshot");
+  check(sameSnapshot(snap, out), "snapshot survives pack/unpack (seq, text, every slot, missing values)");
+
+  check(!relayUnpack(&pkt, sizeof(pkt) - 1, out), "short packet rejected");
+  RelayPacket bad = pkt;
+  bad.magic ^= 1;
+  check(!relayUnpack(&bad, sizeof(bad), out), "wrong magic rejected");
+  bad = pkt;
+  bad.version++;
+  check(!relayUnpack(&bad, sizeof(bad), out), "wrong version rejected");
+  bad = pkt;
+  bad.count = SNAPSHOT_MAX_SLOTS + 1;
+  check(!relayUnpack(&bad, sizeof(bad), out), "slot count above SNAPSHOT_MAX_SLOTS rejected");
+  bad = pkt;
+  bad.slots[10].temp10 ^= 0x40;
+  check(!relayUnpack(&bad, sizeof(bad), out), "flipped slot bit rejected by the CRC");
+  bad = pkt;
+  bad.crc32 ^= 0x80000000u;
+  check(!relayUnpack(&bad, sizeof(bad), out), "flipped CRC bit rejected");
+
+  WeatherSnapshot empty = {};
+  empty.seq = 42;
+  relayPack(empty, pkt);
+  check(relayUnpack(&pkt, sizeof(pkt), out) && !out.valid && out.count == 0 && out.seq == 42,
+        "an invalid snapshot travels as count 0 and unpacks as not valid");
+}
+
+// -------------------------- multicast --------------------------
+// Waits (real time) for the subscriber to hand out a snapshot
+static bool takeWithin(uint32_t ms, WeatherSnapshot &out) {
+  unsigned long start = millis();
+  while (millis() - start < ms) {
+    if (relayTakeLatest(out)) return true;
+    delay(20);
+  }
+  return false;
+}
+
+static bool multicastRouted() {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  if (fd < 0) return false;
+  struct sockaddr_in dst;
+  memset(&dst, 0, sizeof(dst));
+  dst.sin_family = AF_INET;
+  dst.sin_port = htons(RELAY_PORT);
+  dst.sin_addr.s_addr = inet_addr(RELAY_GROUP);
+  bool ok = connect(fd, (struct sockaddr *)&dst, sizeof(dst)) == 0;
+  close(fd);
+  return ok;
+}
+
+// A packet straight onto the group, as a foreign or broken sender would put it there
+static void sendRaw(const RelayPacket &pkt) {
+  int fd = socket(AF_INET, SOCK_DGRAM, 0);
+  struct sockaddr_in dst;
+  memset(&dst, 0, sizeof(dst));
+  dst.sin_family = AF_INET;
+  dst.sin_port = htons(RELAY_PORT);
+  dst.sin_addr.s_addr = inet_addr(RELAY_GROUP);
+  sendto(fd, &pkt, sizeof(pkt), 0, (struct sockaddr *)&dst, sizeof(dst));
+  close(fd);
+}
+
+static void checkMulticast() {
+  if (!multicastRouted()) {
+    printf("note: no route for %s, multicast checks skipped\n", RELAY_GROUP);
+    return;
+  }
+  initRelaySubscriber();
+  initRelayGateway();
+  delay(300);   // both tasks up and the group joined
+
+  static WeatherSnapshot got;
+  WeatherSnapshot first = makeSnapshot(7);
+  relayPublish(first);
+  check(takeWithin(2000, got) && sameSnapshot(first, got), "published snapshot reaches relayTakeLatest()");
+  check(!relayHasLatest() && !relayTakeLatest(got), "a snapshot is handed out once");
+  check(relayHeardWithin(1000), "relayHeardWithin() after a packet");
+
+  // a resend of the same seq (the gateway repeats every RELAY_RESEND_MS) is not new
+  static RelayPacket pkt;
+  relayPack(first, pkt);
+  sendRaw(pkt);
+  check(!takeWithin(500, got), "resend of the same seq not handed out again");
+
+  // a newer seq with a broken CRC never reaches the station
+  relayPack(makeSnapshot(8), pkt);
+  pkt.slots[0].temp10 ^= 1;
+  sendRaw(pkt);
+  check(!takeWithin(500, got), "packet with a bad CRC not handed out");
+
+  WeatherSnapshot second = makeSnapshot(9);
+  relayPublish(second);
+  check(takeWithin(2000, got) && got.seq == 9 && sameSnapshot(second, got), "next seq handed out");
+
+  // two publishes between takes: only the newest is handed out
+  relayPublish(makeSnapshot(10));
+  delay(400);
+  relayPublish(makeSnapshot(11));
+  delay(400);
+  check(takeWithin(2000, got) && got.seq == 11, "newest of two publishes handed out");
+  delay(400);
+  check(!relayTakeLatest(got), "nothing left after the newest");
+}
+
+// -------------------------- HTTP fallback --------------------------
+enum ServeMode { SERVE_OK, SERVE_CORRUPT, SERVE_404 };
+static std::atomic<int> s_serveMode(SERVE_OK);
+static std::atomic<int> s_requests(0);
+static RelayPacket s_servePkt;
+static char s_lastRequest[256];
+
+static void serverLoop(int lfd) {
+  for (;;) {
+    int fd = accept(lfd, nullptr, nullptr);
+    if (fd < 0) continue;
+    int n = recv(fd, s_lastRequest, sizeof(s_lastRequest) - 1, 0);
+    s_lastRequest[n > 0 ? n : 0] = '\0';
+    s_requests++;
+    int mode = s_serveMode;
+    if (mode == SERVE_404) {
+      const char *resp = "HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\n\r\nnot found\n";
+      send(fd, resp, strlen(resp), 0);
+    } else {
+      RelayPacket pkt = s_servePkt;
+      if (mode == SERVE_CORRUPT) pkt.desc[0] ^= 1;
+      const char *hdr = "HTTP/1.0 200 OK\r\nContent-Type: application/octet-stream\r\nConnection: close\r\n\r\n";
+      send(fd, hdr, strlen(hdr), 0);
+      send(fd, &pkt, sizeof(pkt), 0);
+    }
+    close(fd);
+  }
+}
+
+static uint16_t startServer() {
+  int lfd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  addr.sin_port = 0;   // any free port
+  socklen_t len = sizeof(addr);
+  if (lfd < 0 || bind(lfd, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(lfd, 4) != 0 ||
+      getsockname(lfd, (struct sockaddr *)&addr, &len) != 0) {
+    return 0;
+  }
+  std::thread(serverLoop, lfd).detach();
+  return ntohs(addr.sin_port);
+}
+
+static void checkHttp() {
+  uint16_t port = startServer();
+  check(port != 0, "loopback /forecast.bin server started");
+  if (!port) return;
+
+  WeatherSnapshot snap = makeSnapshot(23);
+  relayPack(snap, s_servePkt);
+  static WeatherSnapshot got;
+
+  got = {};
+  s_serveMode = SERVE_OK;
+  check(relayFetchHttp("127.0.0.1", port, got) && sameSnapshot(snap, got), "GET /forecast.bin -> relayUnpack()");
+  check(strncmp(s_lastRequest, "GET /forecast.bin HTTP/1.0\r\nHost: 127.0.0.1\r\n\r\n", sizeof(s_lastRequest)) == 0,
+        "request line and Host header");
+
+  got = {};
+  check(relayFetchHttp("localhost", port, got) && got.seq == 23, "gateway given by name");
+
+  s_serveMode = SERVE_CORRUPT;
+  check(!relayFetchHttp("127.0.0.1", port, got), "corrupted body rejected by the CRC");
+  s_serveMode = SERVE_404;
+  check(!relayFetchHttp("127.0.0.1", port, got), "non-200 reply rejected");
+  s_serveMode = SERVE_OK;
+
+  // a name that does not fit the request is refused before anything is sent
+  char longHost[128];
+  memset(longHost, 'a', sizeof(longHost) - 1);
+  longHost[sizeof(longHost) - 1] = '\0';
+  int before = s_requests;
+  check(!relayFetchHttp(longHost, port, got) && s_requests == before, "host name too long for the request refused");
+}
+
+int main() {
+  hostSerialMute(true);   // RelayUtils logs every start and failure
+  checkPacking();
+  checkMulticast();
+  checkHttp();
+  hostSerialMute(false);
+  printf("relay loopback: %d checks, %d failed\n", s_checks, s_failed);
+  fflush(stdout);
+  _Exit(s_failed ? 1 : 0);   // the gateway, subscriber and server threads never return
+}
@@ -0,0 +1,18 @@
+#ifndef HOST_SPI_H
+#define HOST_SPI_H
+
+// Host stand-in for the Arduino SPI library: the mock display never touches a bus.
+
+#include "Arduino.h"
+
+class SPIClass {
+public:
+  void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {
+    (void)sck; (void)miso; (void)mosi; (void)ss;
+  }
+  void end() {}
+};
+
+extern SPIClass SPI;
+
+#endif // HOST_SPI_H
@@ -0,0 +1,325 @@
+/*
+  Simulator - long-horizon soak run of the real setup()/loop() (host builds only)
+
+  The sketch is compiled as-is against the host stand-ins (MockST7789, WiFi/HTTPClient
+  in HostNet.cpp, in-memory Preferences) on the virtual clock of Arduino.h: time only
+  moves through delay() and the pass step below, so 60 days of loop() take about a
+  minute. OpenWeather is answered by a synthetic but deterministic forecast (diurnal
+  and multi-day swings, so alerts fire now and then).
+
+  Reported: frames and bus bytes, fetches against the expected cadence, timer deadline
+  misses (a timer that fires later than its period + one step), graph-rotation drift,
+  live heap per simulated day and its growth. The exit code is 1 when a timer stalls
+  (no fire for two periods), which is what a millis() wrap bug looks like.
+
+  Build (real Adafruit_GFX and ArduinoJson, as for the device):
+    g++ -std=gnu++17 -O2 -Ihost -I<Adafruit_GFX dir> -I<ArduinoJson dir>/src -o wssim \
+        host/Simulator.cpp host/HostArduino.cpp host/HostNet.cpp host/MockST7789.cpp \
+        <Adafruit_GFX dir>/Adafruit_GFX.cpp *.cpp -lpthread
+  Run:
+    ./wssim --days 60 --quiet                       # wraps millis() on day 49.7
+    ./wssim --days 3 --start-millis 4294000000      # wrap a few minutes after boot
+    ./wssim --days 20 --outage 5d+6h --http-fail 0.1 --seed 7 --png last.png
+  Options: --days N, --step ms (virtual time per loop() pass, default 10000; 40 for
+  frame-accurate runs), --start-millis ms, --epoch s (wall clock at boot),
+  --outage <at>+<dur> (d/h/m/s units, repeatable; Wi-Fi and HTTP fail),
+  --http-fail P (each request fails with probability P), --seed N, --quiet (mute the
+  sketch's Serial), --png path (last frame), --cmd "line" (serial console input after
+  setup(), repeatable; e.g. --cmd "set GRAPH_SWITCH_MS 30000" --cmd prof).
+*/
+
+#include "../WeatherStationV5_copy_20250813090204.ino"
+#include "HostNet.h"
+#include "HTTPClient.h"
+#include <stdio.h>
+#include <new>
+#include <chrono>
+
+// -------------------------- heap accounting --------------------------
+// Every new/delete of the process goes through here (String, ArduinoJson pools, ...)
+static size_t s_heapLive = 0;
+static size_t s_heapPeak = 0;
+static uint64_t s_heapAllocs = 0;
+
+void *operator new(size_t n) {
+  size_t *p = (size_t *)malloc(n + sizeof(size_t) * 2);
+  if (!p) throw std::bad_alloc();
+  p[0] = n;
+  s_heapLive += n;
+  s_heapAllocs++;
+  if (s_heapLive > s_heapPeak) s_heapPeak = s_heapLive;
+  return p + 2;   // keeps 16-byte alignment
+}
+void *operator new[](size_t n) { return operator new(n); }
+void operator delete(void *q) noexcept {
+  if (!q) return;
+  size_t *p = (size_t *)q - 2;
+  s_heapLive -= p[0];
+  free(p);
+}
+void operator delete[](void *q) noexcept { operator delete(q); }
+void operator delete(void *q, size_t) noexcept { operator delete(q); }
+void operator delete[](void *q, size_t) noexcept { operator delete(q); }
+
+// -------------------------- options --------------------------
+struct Outage { uint64_t atMs, durMs; };
+
+static const int MAX_OUTAGES = 8;
+static Outage s_outages[MAX_OUTAGES];
+static int s_outageCount = 0;
+static double s_httpFail = 0;
+static uint32_t s_seed = 1;
+static uint32_t s_startEpoch = 1760000000;
+
+// "3d", "6h", "90m", "45s", "1d+12h"... -> ms (0 on a bad unit)
+static uint64_t parseDuration(const char *s, const char **end) {
+  uint64_t total = 0;
+  while (*s >= '0' && *s <= '9') {
+    char *e;
+    double v = strtod(s, &e);
+    uint64_t unit = 0;
+    switch (*e) {
+      case 'd': unit = 86400000ULL; break;
+      case 'h': unit = 3600000ULL; break;
+      case 'm': unit = 60000ULL; break;
+      case 's': unit = 1000ULL; break;
+      default: if (end) *end = e; return 0;
+    }
+    total += (uint64_t)(v * unit);
+    s = e + 1;
+  }
+  if (end) *end = s;
+  return total;
+}
+
+static bool inOutage(uint64_t ms) {
+  for (int i = 0; i < s_outageCount; ++i) {
+    if (ms >= s_outages[i].atMs && ms < s_outages[i].atMs + s_outages[i].durMs) return true;
+  }
+  return false;
+}
+
+static double nextRandom() {
+  s_seed = s_seed * 1664525u + 1013904223u;
+  return (s_seed >> 8) / 16777216.0;
+}
+
+// -------------------------- network stand-ins --------------------------
+static bool faultHook(HostNetOp op) {
+  if (inOutage(hostClockElapsedMs())) return false;
+  if (op == HOST_NET_HTTP && s_httpFail > 0 && nextRandom() < s_httpFail) return false;
+  return true;
+}
+
+static float hashNoise(uint32_t x) {
+  x ^= x >> 16; x *= 0x7feb352dU; x ^= x >> 15; x *= 0x846ca68bU; x ^= x >> 16;
+  return (x & 0xFFFF) / 65535.0f - 0.5f;
+}
+
+// Synthetic /forecast: 40 slots on the 3-hour UTC grid from the simulated "now"
+static int forecastHandler(const String &url, String &body) {
+  (void)url;
+  uint32_t now = s_startEpoch + (uint32_t)(hostClockElapsedMs() / 1000);
+  uint32_t first = now - now % 10800 + 10800;
+  const long tz = -4 * 3600;
+  char buf[256];
+  body = "{\"cod\":\"200\",\"cnt\":40,\"list\":[";
+  for (int i = 0; i < 40; ++i) {
+    uint32_t dt = first + (uint32_t)i * 10800;
+    float day = dt / 86400.0f;
+    float hourLocal = fmodf((dt + tz) / 3600.0f, 24.0f);
+    float temp = 45 + 15 * sinf(day * 2 * (float)M_PI / 9) + 10 * sinf((hourLocal - 9) * (float)M_PI / 12) + 4 * hashNoise(dt);
+    float wind = fmaxf(0, 9 + 9 * sinf(day * 2 * (float)M_PI / 5 + 1) + 6 * hashNoise(dt * 3));
+    float pop = fminf(1, fmaxf(0, 0.3f + 0.5f * sinf(day * 2 * (float)M_PI / 4) + 0.4f * hashNoise(dt * 7)));
+    int humidity = (int)constrain(60 + 30 * pop + 10 * hashNoise(dt * 11), 5, 100);
+    const char *desc = pop > 0.6f ? "light rain" : pop > 0.3f ? "overcast clouds" : "clear sky";
+    snprintf(buf, sizeof(buf),
+             "%s{\"dt\":%lu,\"main\":{\"temp\":%.2f,\"humidity\":%d},\"wind\":{\"speed\":%.2f},"
+             "\"pop\":%.2f,\"weather\":[{\"description\":\"%s\"}]}",
+             i ? "," : "", (unsigned long)dt, temp, humidity, wind, pop, desc);
+    body += buf;
+  }
+  snprintf(buf, sizeof(buf), "],\"city\":{\"name\":\"Simville\",\"timezone\":%ld}}", tz);
+  body += buf;
+  return HTTP_CODE_OK;
+}
+
+// -------------------------- timer probes --------------------------
+// A probe watches one of the sketch's "last...Ms" timers: each time it changes the
+// timer fired (at the start of the pass that changed it).
+struct TimerProbe {
+  const char *name;
+  const uint32_t *last;
+  uint64_t periodMs;
+  uint32_t seen;
+  uint64_t firstFireMs, lastFireMs;   // elapsed ms
+  uint64_t fires, misses;
+  uint64_t worstLateMs;     // interval - period, worst case
+  bool stalled;
+};
+
+static void probeStart(TimerProbe &p, uint64_t at) {
+  p.seen = *p.last;
+  p.lastFireMs = at;
+}
+
+static void probeCheck(TimerProbe &p, uint64_t passStart, uint64_t stepMs) {
+  if (*p.last != p.seen) {
+    p.seen = *p.last;
+    uint64_t interval = passStart - p.lastFireMs;
+    if (interval > p.periodMs + stepMs) p.misses++;
+    if (interval > p.periodMs && interval - p.periodMs > p.worstLateMs) p.worstLateMs = interval - p.periodMs;
+    if (p.fires == 0) p.firstFireMs = passStart;
+    p.lastFireMs = passStart;
+    p.fires++;
+  } else if (!p.stalled && passStart - p.lastFireMs > 2 * p.periodMs + stepMs) {
+    p.stalled = true;
+    printf("STALL: %s has not fired for %.1f s (day %.2f, millis()=%lu)\n", p.name,
+           (passStart - p.lastFireMs) / 1000.0, passStart / 86400000.0, (unsigned long)millis());
+  }
+}
+
+// -------------------------- main --------------------------
+static void usage() {
+  printf("usage: wssim [--days N] [--step ms] [--start-millis ms] [--epoch s]\n"
+         "             [--outage <at>+<dur>]... [--http-fail P] [--seed N] [--quiet] [--png path]\n"
+         "             [--cmd \"console line\"]...\n");
+}
+
+int main(int argc, char **argv) {
+  double days = 60;
+  uint32_t stepMs = 10000;
+  uint32_t startMillis = 0;
+  bool quiet = false;
+  const char *pngPath = nullptr;
+
+  for (int i = 1; i < argc; ++i) {
+    const char *a = argv[i];
+    const char *v = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (!strcmp(a, "--quiet")) { quiet = true; continue; }
+    if (!v) { usage(); return 2; }
+    ++i;
+    if (!strcmp(a, "--days")) days = atof(v);
+    else if (!strcmp(a, "--step")) stepMs = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(a, "--start-millis")) startMillis = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(a, "--epoch")) s_startEpoch = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(a, "--http-fail")) s_httpFail = atof(v);
+    else if (!strcmp(a, "--seed")) s_seed = (uint32_t)strtoul(v, nullptr, 10);
+    else if (!strcmp(a, "--png")) pngPath = v;
+    else if (!strcmp(a, "--cmd")) { hostSerialInput(v); hostSerialInput("\n"); }
+    else if (!strcmp(a, "--outage") && s_outageCount < MAX_OUTAGES) {
+      const char *e;
+      Outage o;
+      o.atMs = parseDuration(v, &e);
+      o.durMs = *e == '+' ? parseDuration(e + 1, &e) : 0;
+      if (*e || o.durMs == 0) { printf("bad --outage '%s' (e.g. 10d+3h)\n", v); return 2; }
+      s_outages[s_outageCount++] = o;
+    } else { usage(); return 2; }
+  }
+  if (stepMs == 0) stepMs = 1;
+  uint64_t endMs = (uint64_t)(days * 86400000.0);
+
+  hostClockStart(startMillis, s_startEpoch);
+  hostNetSetFaultHook(faultHook);
+  hostHttpSetHandler(forecastHandler);
+  hostSerialMute(quiet);
+
+  auto wallStart = std::chrono::steady_clock::now();
+  setup();
+  size_t heapAfterSetup = s_heapLive;
+
+  TimerProbe probes[] = {
+    { "ticker",  &lastSmallScrollMs,  smallScrollInterval,   0, 0, 0, 0, 0, 0, false },
+    { "clock",   &lastClockUpdateMs,  clockUpdateIntervalMs, 0, 0, 0, 0, 0, 0, false },
+    { "graph",   &lastGraphSwitchMs,  GRAPH_SWITCH_MS,       0, 0, 0, 0, 0, 0, false },
+    { "weather", &lastWeatherCheckMs, WEATHER_REFRESH_MS,    0, 0, 0, 0, 0, 0, false },
+  };
+  const int PROBES = sizeof(probes) / sizeof(probes[0]);
+  for (int i = 0; i < PROBES; ++i) probeStart(probes[i], hostClockElapsedMs());
+  TimerProbe &graph = probes[2];
+
+  uint64_t passes = 0, overruns = 0, wraps = 0, lastPassStart = 0;
+  uint32_t prevMillis = millis();
+  uint64_t nextDayMs = 86400000ULL;
+  size_t heapDayStart = heapAfterSetup;
+  WeatherFetchStats fetchDayStart = getWeatherFetchStats();
+  uint64_t missesDayStart = 0;
+
+  printf("day   live heap      delta  fetches  failures  misses\n");
+  while (hostClockElapsedMs() < endMs) {
+    uint64_t passStart = hostClockElapsedMs();
+    lastPassStart = passStart;
+    loop();
+    passes++;
+    for (int i = 0; i < PROBES; ++i) probeCheck(probes[i], passStart, stepMs);
+
+    uint64_t used = hostClockElapsedMs() - passStart;
+    if (used < stepMs) hostClockAdvanceMs((uint32_t)(stepMs - used));
+    else overruns++;   // a fetch or reconnect took longer than a pass
+
+    uint32_t m = millis();
+    if (m < prevMillis) {
+      wraps++;
+      printf("millis() wrapped on day %.2f\n", hostClockElapsedMs() / 86400000.0);
+    }
+    prevMillis = m;
+
+    if (hostClockElapsedMs() >= nextDayMs) {
+      WeatherFetchStats f = getWeatherFetchStats();
+      uint64_t misses = 0;
+      for (int i = 0; i < PROBES; ++i) misses += probes[i].misses;
+      printf("%3llu %11zu %+10lld %8lu %9lu %7llu\n", (unsigned long long)(nextDayMs / 86400000ULL),
+             s_heapLive, (long long)s_heapLive - (long long)heapDayStart,
+             (unsigned long)(f.attempts - fetchDayStart.attempts),
+             (unsigned long)(f.failures - fetchDayStart.failures),
+             (unsigned long long)(misses - missesDayStart));
+      heapDayStart = s_heapLive;
+      missesDayStart = misses;
+      fetchDayStart = f;
+      nextDayMs += 86400000ULL;
+    }
+  }
+  double wallSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+  uint64_t elapsed = hostClockElapsedMs();
+
+  printf("\n== %.2f simulated days in %.2f s (%llu passes of %lu ms, %llu overran, %llu millis() wraps)\n",
+         elapsed / 86400000.0, wallSec, (unsigned long long)passes, (unsigned long)stepMs,
+         (unsigned long long)overruns, (unsigned long long)wraps);
+
+  const FrameStats &bus = tft.totals();
+#if DISPLAY_FRAMEBUFFER
+  const FramebufferStats &fb = frame.stats();
+  printf("frames:   %lu flushes, %lu windows\n", (unsigned long)fb.flushes, (unsigned long)fb.windows);
+#endif
+  printf("bus:      %lu transactions, %lu bytes\n", bus.transactions, bus.bytes);
+
+  WeatherFetchStats f = getWeatherFetchStats();
+  printf("fetches:  %lu attempts, %lu failed (expected about %llu)\n", (unsigned long)f.attempts,
+         (unsigned long)f.failures, (unsigned long long)(elapsed / WEATHER_REFRESH_MS));
+  HostNetStats n = hostNetStats();
+  printf("network:  %lu associations (%lu refused), %lu link drops, %lu HTTP (%lu failed), %lu SNTP syncs\n",
+         (unsigned long)n.associations, (unsigned long)n.associateFailures, (unsigned long)n.linkDrops,
+         (unsigned long)n.httpRequests, (unsigned long)n.httpFailures, (unsigned long)n.ntpSyncs);
+
+  bool stalled = false;
+  printf("timers:   %-8s %10s %8s %12s\n", "", "fires", "misses", "worst late");
+  for (int i = 0; i < PROBES; ++i) {
+    TimerProbe &p = probes[i];
+    printf("          %-8s %10llu %8llu %10.1f s%s\n", p.name, (unsigned long long)p.fires,
+           (unsigned long long)p.misses, p.worstLateMs / 1000.0, p.stalled ? "  STALLED" : "");
+    stalled |= p.stalled;
+  }
+  // rotation drift: switches that happened vs. switches due since the first one
+  long long behind = graph.fires == 0 ? 0 :
+      (long long)((lastPassStart - graph.firstFireMs) / GRAPH_SWITCH_MS + 1) - (long long)graph.fires;
+  printf("graph:    %lld switches behind schedule\n", behind);
+
+  double simDays = elapsed / 86400000.0;
+  printf("heap:     %zu B after setup, %zu B at end (%+.0f B/day), peak %zu B, %llu allocations\n",
+         heapAfterSetup, s_heapLive, simDays > 0 ? ((double)s_heapLive - heapAfterSetup) / simDays : 0.0,
+         s_heapPeak, (unsigned long long)s_heapAllocs);
+
+  if (pngPath) tft.writePng(pngPath);
+  fflush(stdout);
+  _Exit(stalled ? 1 : 0);   // the status server thread is still blocked in accept()
+}
@@ -0,0 +1,80 @@
+#ifndef HOST_WSTRING_H
+#define HOST_WSTRING_H
+
+// Host stand-in for the Arduino String class.
+// Only the subset used by the sketch modules is provided; it is backed by std::string
+// so behaviour (copies, concatenation, heap use) stays close to the real thing.
+
+#include <string>
+#include <cstring>
+#include <cstdio>
+#include <cstdlib>
+#include <strings.h>
+
+class String {
+public:
+  String() {}
+  String(const char *s) : s_(s ? s : "") {}
+  String(const std::string &s) : s_(s) {}
+  String(char c) : s_(1, c) {}
+  String(int v)           { char b[16]; snprintf(b, sizeof(b), "%d", v);  s_ = b; }
+  String(unsigned int v)  { char b[16]; snprintf(b, sizeof(b), "%u", v);  s_ = b; }
+  String(long v)          { char b[24]; snprintf(b, sizeof(b), "%ld", v); s_ = b; }
+  String(unsigned long v) { char b[24]; snprintf(b, sizeof(b), "%lu", v); s_ = b; }
+  String(float v, unsigned char decimals = 2)  { fromDouble(v, decimals); }
+  String(double v, unsigned char decimals = 2) { fromDouble(v, decimals); }
+
+  unsigned int length() const { return (unsigned int)s_.size(); }
+  const char *c_str() const { return s_.c_str(); }
+  bool reserve(unsigned int n) { s_.reserve(n); return true; }
+
+  String substring(unsigned int from) const { return from >= s_.size() ? String() : String(s_.substr(from)); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) { unsigned int t = from; from = to; to = t; }
+    if (from >= s_.size()) return String();
+    return String(s_.substr(from, to - from));
+  }
+  int indexOf(char c, unsigned int from = 0) const {
+    size_t p = s_.find(c, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  int indexOf(const String &str, unsigned int from = 0) const {
+    size_t p = s_.find(str.s_, from);
+    return p == std::string::npos ? -1 : (int)p;
+  }
+  bool startsWith(const String &p) const { return s_.compare(0, p.s_.size(), p.s_) == 0; }
+  bool equalsIgnoreCase(const String &o) const { return strcasecmp(s_.c_str(), o.s_.c_str()) == 0; }
+  void trim() {
+    size_t b = s_.find_first_not_of(" \t\r\n");
+    size_t e = s_.find_last_not_of(" \t\r\n");
+    s_ = (b == std::string::npos) ? std::string() : s_.substr(b, e - b + 1);
+  }
+  long toInt() const { return strtol(s_.c_str(), nullptr, 10); }
+  float toFloat() const { return strtof(s_.c_str(), nullptr); }
+
+  char operator[](unsigned int i) const { return i < s_.size() ? s_[i] : 0; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+
+  String &operator+=(const String &o) { s_ += o.s_; return *this; }
+  String &operator+=(const char *o) { if (o) s_ += o; return *this; }
+  String &operator+=(char c) { s_ += c; return *this; }
+  bool concat(const String &o) { s_ += o.s_; return true; }
+
+  friend String operator+(const String &a, const String &b) { return String(a.s_ + b.s_); }
+  friend String operator+(const String &a, const char *b) { return String(a.s_ + (b ? b : "")); }
+  friend String operator+(const char *a, const String &b) { return String((a ? a : "") + b.s_); }
+  friend bool operator==(const String &a, const String &b) { return a.s_ == b.s_; }
+  friend bool operator==(const String &a, const char *b) { return a.s_ == (b ? b : ""); }
+  friend bool operator!=(const String &a, const String &b) { return a.s_ != b.s_; }
+  friend bool operator!=(const String &a, const char *b) { return !(a == b); }
+
+private:
+  void fromDouble(double v, unsigned char decimals) {
+    char b[48];
+    snprintf(b, sizeof(b), "%.*f", (int)decimals, v);
+    s_ = b;
+  }
+  std::string s_;
+};
+
+#endif // HOST_WSTRING_H
@@ -0,0 +1,58 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+// Host stand-in for the ESP32 WiFi library (station mode only); behaviour and fault
+// injection are controlled through HostNet.h, implemented in HostNet.cpp.
+
+#include "Arduino.h"
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6,
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+typedef enum { WIFI_PS_NONE, WIFI_PS_MIN_MODEM, WIFI_PS_MAX_MODEM } wifi_ps_type_t;
+
+class IPAddress {
+public:
+  IPAddress() : addr_(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+    : addr_((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) | ((uint32_t)d << 24)) {}
+  uint8_t operator[](int i) const { return (uint8_t)(addr_ >> (8 * i)); }
+  operator uint32_t() const { return addr_; }
+  String toString() const {
+    char buf[16];
+    snprintf(buf, sizeof(buf), "%u.%u.%u.%u", (*this)[0], (*this)[1], (*this)[2], (*this)[3]);
+    return String(buf);
+  }
+private:
+  uint32_t addr_;
+};
+
+class WiFiClass {
+public:
+  wl_status_t begin(const char *ssid, const char *passphrase = nullptr, int32_t channel = 0,
+                    const uint8_t *bssid = nullptr, bool connect = true);
+  wl_status_t status();
+  bool disconnect(bool wifiOff = false, bool eraseAp = false);
+  bool mode(wifi_mode_t m);
+  wifi_mode_t getMode();
+  bool setSleep(bool enabled);
+  bool setSleep(wifi_ps_type_t type);
+  wifi_ps_type_t getSleep();
+  bool setAutoReconnect(bool autoReconnect);
+  void persistent(bool persistent);
+  IPAddress localIP();
+  int32_t channel();
+  uint8_t *BSSID();
+  int8_t RSSI();
+};
+
+extern WiFiClass WiFi;
+
+#endif // HOST_WIFI_H